@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include "board_eval.h"
+#include "tetris_engine.h"
+
+// "Bastet"-style piece chooser for a challenge mode: the next piece is the one that
+// leaves the player worst off. For every piece type, the player's best outcome is the
+// best two-piece plan: the current piece dropped anywhere, then the new piece's best
+// placement on what's left, scored with the board heuristic (plus lines the current
+// piece clears). Like the original game, the worst piece is picked most of the time
+// and the second or third worst otherwise, so there's no endless stream of S pieces.
+//
+// That's 7 placement searches per landing spot of the current piece, a few hundred
+// batched evaluations per spawn, using findBestPlacement()'s scratch buffers, so
+// nothing is allocated. The search runs inside tick(), so it has a strict time budget;
+// past it, the piece comes from the engine's random generator as usual.
+const int ADVERSARY_BUDGET_US = FRAME_MS * 1000 / 10; // A tenth of a frame
+
+// Percent chances of handing out the worst, second and third worst piece
+const int ADVERSARY_PICK_PERCENT[3] = {75, 17, 8};
+
+struct ChooserStats {
+    uint64_t decisions = 0;
+    uint64_t fallbacks = 0; // Decisions that ran out of time and went random
+    uint64_t blocked = 0;   // Decisions with nowhere to drop the current piece, random too
+    double totalSeconds = 0;
+    double maxSeconds = 0;
+};
+
+class AdversarialChooser : public PieceChooser {
+public:
+    explicit AdversarialChooser(int budgetMicros = ADVERSARY_BUDGET_US) : budget(std::chrono::microseconds(budgetMicros)) {}
+
+    Tetromino::Type choosePiece(const Board& board, Tetromino::Type current, PieceRandom& random) override {
+        auto start = std::chrono::steady_clock::now();
+        auto deadline = start + budget;
+        float values[PIECE_TYPES];
+        Outcome outcome = search(board, current, deadline, values);
+
+        Tetromino::Type choice;
+        if (outcome == SEARCHED) {
+            int order[PIECE_TYPES];
+            for (int t = 0; t < PIECE_TYPES; t++) order[t] = t;
+            std::stable_sort(order, order + PIECE_TYPES, [&](int a, int b) { return values[a] < values[b]; });
+            int roll = static_cast<int>(random.next() % 100);
+            int rank = roll < ADVERSARY_PICK_PERCENT[0] ? 0 : roll < ADVERSARY_PICK_PERCENT[0] + ADVERSARY_PICK_PERCENT[1] ? 1 : 2;
+            choice = static_cast<Tetromino::Type>(order[rank]);
+        } else {
+            // Out of time, or the current piece tops out and the next one won't matter
+            choice = static_cast<Tetromino::Type>(random.next() % PIECE_TYPES);
+            if (outcome == OUT_OF_TIME) {
+                stats.fallbacks++;
+            } else {
+                stats.blocked++;
+            }
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        stats.decisions++;
+        stats.totalSeconds += seconds;
+        stats.maxSeconds = std::max(stats.maxSeconds, seconds);
+        if (log) {
+            static const char* const NOTES[3] = {"", " (over budget, random)", " (no placements, random)"};
+            std::fprintf(log, "piece %d: %.1f us%s\n", static_cast<int>(choice), seconds * 1e6, NOTES[outcome]);
+        }
+        return choice;
+    }
+
+    ChooserStats stats;
+    FILE* log = nullptr; // One line per decision when set
+
+private:
+    enum Outcome { SEARCHED, OUT_OF_TIME, NO_PLACEMENTS };
+
+    std::chrono::steady_clock::duration budget;
+
+    // The player's best two-piece score for each next piece type
+    Outcome search(const Board& board, Tetromino::Type current, std::chrono::steady_clock::time_point deadline,
+                   float* values) {
+        EvalWeights weights;
+        Placement placements[MAX_PLACEMENTS];
+        int count = enumeratePlacements(board, current, placements);
+        if (count == 0) return NO_PLACEMENTS;
+
+        for (int t = 0; t < PIECE_TYPES; t++) {
+            values[t] = -1e30f;
+        }
+        for (int i = 0; i < count; i++) {
+            if (std::chrono::steady_clock::now() > deadline) return OUT_OF_TIME;
+            Board child = applyPlacement(board, placements[i]);
+            float cleared = weights.lines * child.clearLines();
+            for (int t = 0; t < PIECE_TYPES; t++) {
+                // A piece with nowhere to go keeps the lowest value, so it's the one picked
+                SearchResult best = findBestPlacement(child, static_cast<Tetromino::Type>(t), weights);
+                if (best.found) values[t] = std::max(values[t], cleared + best.score);
+            }
+        }
+        return SEARCHED;
+    }
+};
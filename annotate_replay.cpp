@@ -0,0 +1,76 @@
+// Annotates every piece of a recorded game with how close the board was to a forced top-out.
+// For each new piece the board is searched by SurvivalAnalyzer: "survives" means no piece
+// sequence tops the player out within the search depth, otherwise the worst sequence
+// ends the game after the given number of pieces.
+// danger = 1 - pieces / depth for a forced top-out, 0 when the board survives the depth.
+// Build: g++ -O2 -std=c++17 -pthread annotate_replay.cpp -o annotate_replay
+// Usage: annotate_replay [replay=tetris_replay.bin] [depth=4] [threads=all cores]
+#include <cstdio>
+#include <cstdlib>
+#include "replay.h"
+#include "survival.h"
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 ? argv[1] : "tetris_replay.bin";
+    int depth = argc > 2 ? std::atoi(argv[2]) : 4;
+    int threads = argc > 3 ? std::atoi(argv[3]) : static_cast<int>(std::thread::hardware_concurrency());
+    if (depth < 1 || depth > SURVIVAL_MAX_DEPTH) {
+        std::fprintf(stderr, "depth must be 1-%d\n", SURVIVAL_MAX_DEPTH);
+        return 1;
+    }
+
+    Replay replay;
+    if (!replay.load(path)) {
+        std::fprintf(stderr, "can't read replay %s\n", path);
+        return 1;
+    }
+
+    SurvivalAnalyzer analyzer(threads > 0 ? threads : 1, 20);
+    TetrisEngine engine(replay.seed);
+    uint32_t analyzedPiece = 0;
+    int pieces = 0, forced = 0;
+    double totalSeconds = 0, worstDanger = 0;
+    uint32_t worstPiece = 0;
+    std::printf("piece   tick  height  result                      danger\n");
+    for (size_t tick = 0; tick <= replay.inputs.size(); tick++) {
+        if (engine.gameState == GameState::PLAYING && engine.pieces != analyzedPiece) {
+            analyzedPiece = engine.pieces;
+            Board board = Board::fromGrid(engine.grid);
+            SurvivalResult result = analyzer.analyze(board, depth);
+            totalSeconds += result.seconds;
+            pieces++;
+
+            int height = 0;
+            for (int y = 0; y < GRID_HEIGHT; y++) {
+                if (board.rows[y]) {
+                    height = GRID_HEIGHT - y;
+                    break;
+                }
+            }
+            double danger = result.forced ? 1.0 - double(result.pieces) / depth : 0.0;
+            char text[64];
+            if (result.forced) {
+                std::snprintf(text, sizeof(text), "forced top-out in %d", result.pieces);
+                forced++;
+            } else {
+                std::snprintf(text, sizeof(text), "survives %d", result.depth);
+            }
+            std::printf("%5u  %5zu  %6d  %-26s  %.2f\n", analyzedPiece, tick, height, text, danger);
+            if (danger > worstDanger) {
+                worstDanger = danger;
+                worstPiece = analyzedPiece;
+            }
+        }
+        if (tick == replay.inputs.size()) break;
+        engine.tick(replay.inputs[tick]);
+    }
+
+    std::printf("%d pieces analyzed at depth %d in %.2f s (%.2f ms per piece), %d with a forced top-out",
+                pieces, depth, totalSeconds, pieces ? totalSeconds * 1e3 / pieces : 0.0, forced);
+    if (forced) std::printf(", most dangerous: piece %u (%.2f)", worstPiece, worstDanger);
+    std::printf("\n");
+    if (engine.score != replay.finalScore) {
+        std::fprintf(stderr, "warning: replay reached score %d, recorded %d\n", engine.score, replay.finalScore);
+    }
+    return 0;
+}
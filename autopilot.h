@@ -0,0 +1,26 @@
+#pragma once
+
+#include "tetris_engine.h"
+
+// Next input that steers the engine's falling piece to `target` the way a player
+// would: rotate until the shape matches, slide to the column, then hard drop.
+// Returns Input::HARD_DROP as the final step. Works with any rule set, since only the
+// shape after each turn matters and not how the rotation system got there.
+template <typename Engine>
+Input pilotInput(const Engine& game, const Placement& target) {
+    int minX, minY;
+    PieceShape shape = makePieceShape(game.currentPiece.shape, minX, minY);
+    if (!samePieceShape(shape, pieceTable().shapes[target.type][target.rotation])) {
+        return Input::ROTATE;
+    }
+    if (game.pieceX + minX > target.x) {
+        return Input::LEFT;
+    }
+    if (game.pieceX + minX < target.x) {
+        return Input::RIGHT;
+    }
+    return Input::HARD_DROP;
+}
+
+// Most inputs pilotInput() can need for one piece; more means a move was blocked
+const int PILOT_MAX_STEPS = 2 * MAX_ROTATIONS + GRID_WIDTH;
@@ -0,0 +1,781 @@
+// Headless benchmarks for the AI and engine code.
+// Build: g++ -O2 -std=c++17 -pthread bench.cpp -o bench
+// Usage: bench <name>   (run without arguments to list benchmarks)
+#include <algorithm>
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "adversarial_chooser.h"
+#include "autopilot.h"
+#include "board_eval.h"
+#include "nnue.h"
+#include "reference_engine.h"
+#include "session_store.h"
+#include "survival.h"
+#include "tetris_env.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Boards sampled from games played by the placement search, so they look like real stacks
+static std::vector<Board> sampleBoards(int count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<Board> boards;
+    Board board;
+    while (static_cast<int>(boards.size()) < count) {
+        Tetromino::Type type = static_cast<Tetromino::Type>(rng() % PIECE_TYPES);
+        Placement placements[MAX_PLACEMENTS];
+        int n = enumeratePlacements(board, type, placements);
+        if (n == 0 || spawnBlocked(board, type)) {
+            board.clear();
+            continue;
+        }
+        // Mostly sensible moves with some noise so holes show up
+        Placement chosen = placements[rng() % n];
+        if (rng() % 4 != 0) {
+            chosen = findBestPlacement(board, type, EvalWeights(), evaluateBoardsScalar).placement;
+        }
+        board = applyPlacement(board, chosen);
+        boards.push_back(board);
+        board.clearLines();
+    }
+    return boards;
+}
+
+static int benchEval() {
+    std::vector<Board> boards = sampleBoards(BOARD_SET_CAPACITY * 256, 1234);
+    std::vector<BoardSet> sets(boards.size() / BOARD_SET_CAPACITY);
+    for (size_t i = 0; i < boards.size(); i++) {
+        BoardSet& set = sets[i / BOARD_SET_CAPACITY];
+        set.add(boards[i]);
+    }
+
+    // Both paths must agree before their speed means anything
+    BoardFeatures scalar, simd;
+    EvaluateBoardsFn fast = selectBoardEvaluator();
+    for (const BoardSet& set : sets) {
+        evaluateBoardsScalar(set, scalar);
+        fast(set, simd);
+        if (std::memcmp(&scalar, &simd, sizeof(scalar)) != 0) {
+            std::cerr << "evaluator mismatch between scalar and dispatched path\n";
+            return 1;
+        }
+    }
+
+    const int rounds = 2000;
+    struct Path { const char* name; EvaluateBoardsFn fn; };
+    Path paths[] = {{"scalar", evaluateBoardsScalar}, {"dispatched", fast}};
+    long long sink = 0;
+    for (const Path& path : paths) {
+        BoardFeatures features;
+        auto start = Clock::now();
+        for (int r = 0; r < rounds; r++) {
+            for (const BoardSet& set : sets) {
+                path.fn(set, features);
+                sink += features.holes[r % BOARD_SET_CAPACITY];
+            }
+        }
+        double seconds = secondsSince(start);
+        double boardsPerSecond = double(rounds) * boards.size() / seconds;
+        std::cout << "eval " << path.name << ": " << boardsPerSecond / 1e6 << " M boards/s\n";
+    }
+    std::cout << "avx2 available: " << (fast != evaluateBoardsScalar ? "yes" : "no") << "\n";
+
+    // Whole placement search: enumerate, batch and score every landing of a piece
+    const int searches = 200000;
+    for (const Path& path : paths) {
+        auto start = Clock::now();
+        for (int i = 0; i < searches; i++) {
+            const Board& board = boards[i % boards.size()];
+            SearchResult result = findBestPlacement(board, static_cast<Tetromino::Type>(i % PIECE_TYPES),
+                                                    EvalWeights(), path.fn);
+            sink += result.placement.x;
+        }
+        double seconds = secondsSince(start);
+        std::cout << "search " << path.name << ": " << searches / seconds / 1e3 << " K searches/s\n";
+    }
+    // Printed so the compiler can't drop the work behind it
+    std::cout << "checksum: " << sink << "\n";
+    return 0;
+}
+
+static int benchNnue() {
+    static NnueNetwork net;
+    net.randomize(99);
+
+    // Play placement-search games, checking the incremental accumulator against a full
+    // refresh and the SIMD evaluation against the scalar reference at every step
+    std::mt19937 rng(7);
+    std::vector<NnueAccumulator> accumulators;
+    std::vector<Board> boards;
+    Board board;
+    NnueAccumulator acc;
+    acc.reset(net);
+    NnueEvaluateFn fast = selectNnueEvaluator();
+    while (boards.size() < 4096) {
+        Tetromino::Type type = static_cast<Tetromino::Type>(rng() % PIECE_TYPES);
+        SearchResult result = findBestPlacement(board, type);
+        if (!result.found || spawnBlocked(board, type)) {
+            board.clear();
+            acc.reset(net);
+            continue;
+        }
+        Board after;
+        nnueApplyPlacement(net, board, result.placement, acc, after);
+        board = after;
+
+        NnueAccumulator fresh;
+        fresh.refresh(net, board);
+        if (std::memcmp(&fresh, &acc, sizeof(acc)) != 0) {
+            std::cerr << "incremental accumulator drifted from refresh\n";
+            return 1;
+        }
+        if (nnueEvaluateScalar(net, acc) != fast(net, acc)) {
+            std::cerr << "nnue mismatch between scalar and dispatched path\n";
+            return 1;
+        }
+        boards.push_back(board);
+        accumulators.push_back(acc);
+    }
+
+    const int rounds = 100;
+    double sink = 0;
+    struct Path { const char* name; NnueEvaluateFn fn; };
+    Path paths[] = {{"scalar", nnueEvaluateScalar}, {"dispatched", fast}};
+    for (const Path& path : paths) {
+        auto start = Clock::now();
+        for (int r = 0; r < rounds; r++) {
+            for (const NnueAccumulator& a : accumulators) {
+                sink += path.fn(net, a);
+            }
+        }
+        double seconds = secondsSince(start);
+        std::cout << "nnue eval " << path.name << ": " << rounds * accumulators.size() / seconds / 1e6 << " M evals/s\n";
+    }
+
+    // Heuristic on the same boards, batched the way findBestPlacement() uses it
+    {
+        BoardSet set;
+        BoardFeatures features;
+        EvalWeights weights;
+        auto start = Clock::now();
+        for (int r = 0; r < rounds; r++) {
+            for (size_t i = 0; i < boards.size(); i += BOARD_SET_CAPACITY) {
+                set.clear();
+                for (size_t j = i; j < boards.size() && j < i + BOARD_SET_CAPACITY; j++) {
+                    set.add(boards[j]);
+                }
+                evaluateBoards(set, features);
+                for (int j = 0; j < set.count; j++) {
+                    sink += scoreFeatures(features, j, weights);
+                }
+            }
+        }
+        double seconds = secondsSince(start);
+        std::cout << "heuristic eval: " << rounds * boards.size() / seconds / 1e6 << " M evals/s\n";
+    }
+
+    // First layer: incremental placement update vs rebuilding from the grid
+    {
+        auto start = Clock::now();
+        for (int r = 0; r < rounds; r++) {
+            for (const Board& b : boards) {
+                NnueAccumulator fresh;
+                fresh.refresh(net, b);
+                sink += fresh.values[r % NNUE_HIDDEN];
+            }
+        }
+        double refresh = secondsSince(start);
+
+        std::vector<Placement> moves;
+        std::vector<size_t> from;
+        for (size_t i = 0; i < boards.size(); i++) {
+            Placement placements[MAX_PLACEMENTS];
+            int n = enumeratePlacements(boards[i], static_cast<Tetromino::Type>(i % PIECE_TYPES), placements);
+            if (n == 0) continue;
+            moves.push_back(placements[i % n]);
+            from.push_back(i);
+        }
+        start = Clock::now();
+        long long updates = 0;
+        for (int r = 0; r < rounds; r++) {
+            for (size_t m = 0; m < moves.size(); m++) {
+                NnueAccumulator child = accumulators[from[m]];
+                Board after;
+                nnueApplyPlacement(net, boards[from[m]], moves[m], child, after);
+                sink += child.values[r % NNUE_HIDDEN];
+                updates++;
+            }
+        }
+        double incremental = secondsSince(start);
+        std::cout << "accumulator refresh: " << rounds * boards.size() / refresh / 1e6 << " M/s, "
+                  << "incremental placement: " << updates / incremental / 1e6 << " M/s\n";
+    }
+
+    // Whole placement searches with each evaluator
+    {
+        const int searches = 20000;
+        auto start = Clock::now();
+        for (int i = 0; i < searches; i++) {
+            sink += findBestPlacementNnue(net, accumulators[i % accumulators.size()], boards[i % boards.size()],
+                                          static_cast<Tetromino::Type>(i % PIECE_TYPES)).score;
+        }
+        double nnue = secondsSince(start);
+        start = Clock::now();
+        for (int i = 0; i < searches; i++) {
+            sink += findBestPlacement(boards[i % boards.size()], static_cast<Tetromino::Type>(i % PIECE_TYPES)).score;
+        }
+        double heuristic = secondsSince(start);
+        std::cout << "search nnue: " << searches / nnue / 1e3 << " K searches/s, heuristic: "
+                  << searches / heuristic / 1e3 << " K searches/s\n";
+    }
+    std::cout << "checksum: " << sink << "\n";
+    return 0;
+}
+
+static int benchEnv() {
+    const int games = 4096;
+    const int steps = 2000;
+    int threads = static_cast<int>(std::thread::hardware_concurrency());
+    if (threads < 1) threads = 1;
+    VecEnv env(games, threads);
+
+    std::vector<uint32_t> seeds(games);
+    for (int i = 0; i < games; i++) {
+        seeds[i] = 1000 + i;
+    }
+    std::vector<uint8_t> observations(static_cast<size_t>(games) * OBS_SIZE);
+    std::vector<float> rewards(games);
+    std::vector<uint8_t> dones(games);
+    env.reset(seeds.data(), observations.data());
+
+    // Random actions, generated up front so only the environment is timed
+    std::mt19937 rng(3);
+    std::vector<uint8_t> actions(static_cast<size_t>(games) * 64);
+    for (auto& action : actions) {
+        action = static_cast<uint8_t>(rng() % INPUT_COUNT);
+    }
+
+    double totalReward = 0;
+    long long episodes = 0;
+    auto start = Clock::now();
+    for (int step = 0; step < steps; step++) {
+        env.step(&actions[static_cast<size_t>(step % 64) * games], observations.data(), rewards.data(), dones.data());
+        for (int i = 0; i < games; i++) {
+            totalReward += rewards[i];
+            episodes += dones[i];
+        }
+    }
+    double seconds = secondsSince(start);
+    std::cout << "env: " << games << " games x " << steps << " steps on " << threads << " threads: "
+              << double(games) * steps / seconds / 1e6 << " M steps/s (" << episodes << " episodes, "
+              << totalReward << " total reward)\n";
+    return 0;
+}
+
+// Plays `games` games of `ticks` frames from a fixed input script; returns ticks per second
+template <typename Engine>
+static double engineThroughput(const std::vector<Input>& script, int games, int ticks, long long& sink) {
+    Engine engine;
+    auto start = Clock::now();
+    for (int g = 0; g < games; g++) {
+        engine.reset(1000 + g);
+        for (int t = 0; t < ticks; t++) {
+            if (engine.gameState != GameState::PLAYING) {
+                engine.reset(engine.random.next());
+            }
+            engine.tick(script[(g * 7919 + t) % script.size()]);
+        }
+        sink += engine.score;
+    }
+    return double(games) * ticks / secondsSince(start);
+}
+
+static int benchRules() {
+    // Random inputs weighted toward moves and rotations so pieces travel and stacks grow
+    std::mt19937 rng(11);
+    const Input weighted[] = {Input::NONE, Input::LEFT, Input::RIGHT, Input::ROTATE, Input::ROTATE,
+                              Input::SOFT_DROP, Input::LEFT, Input::RIGHT, Input::HARD_DROP};
+    std::vector<Input> script(1 << 16);
+    for (Input& input : script) {
+        input = weighted[rng() % (sizeof(weighted) / sizeof(weighted[0]))];
+    }
+
+    // The classic policies must play exactly like the engine they replaced
+    for (int g = 0; g < 200; g++) {
+        ReferenceEngine reference(g + 1);
+        TetrisEngine engine(g + 1);
+        for (int t = 0; t < 5000; t++) {
+            Input input = script[(g * 7919 + t) % script.size()];
+            reference.tick(input);
+            engine.tick(input);
+            if (hashState(reference) != hashState(engine)) {
+                std::cerr << "classic rules diverged from the reference engine (game " << g << ", tick " << t << ")\n";
+                return 1;
+            }
+        }
+    }
+
+    // Four SRS turns on an open board bring every piece back to its spawn shape and spot
+    for (int t = 0; t < PIECE_TYPES; t++) {
+        GuidelineEngine engine;
+        engine.currentPiece = Tetromino(static_cast<Tetromino::Type>(t));
+        SrsRotation::spawn(engine.currentPiece);
+        engine.pieceY = 5;
+        Tetromino::Shape spawnShape = engine.currentPiece.shape;
+        for (int r = 0; r < 4; r++) {
+            engine.rotatePiece();
+        }
+        if (engine.rotation != 0 || engine.pieceX != SPAWN_X || engine.pieceY != 5
+            || std::memcmp(&spawnShape, &engine.currentPiece.shape, sizeof(spawnShape)) != 0) {
+            std::cerr << "SRS rotation of piece " << t << " doesn't cycle back to spawn\n";
+            return 1;
+        }
+    }
+
+    const int games = 2000;
+    const int ticks = 5000;
+    long long sink = 0;
+    // Alternate runs and keep each engine's best, so frequency scaling and a cold first
+    // run don't favour or punish whichever goes first
+    double reference = 0, classic = 0, guideline = 0, house = 0;
+    for (int round = 0; round < 3; round++) {
+        reference = std::max(reference, engineThroughput<ReferenceEngine>(script, games, ticks, sink));
+        classic = std::max(classic, engineThroughput<TetrisEngine>(script, games, ticks, sink));
+        guideline = std::max(guideline, engineThroughput<GuidelineEngine>(script, games, ticks, sink));
+        house = std::max(house, engineThroughput<HouseEngine>(script, games, ticks, sink));
+    }
+    std::cout << "reference engine: " << reference / 1e6 << " M ticks/s\n"
+              << "classic policies: " << classic / 1e6 << " M ticks/s (" << 100 * classic / reference << "% of reference)\n"
+              << "guideline policies: " << guideline / 1e6 << " M ticks/s (" << 100 * guideline / reference << "%)\n"
+              << "house policies: " << house / 1e6 << " M ticks/s (" << 100 * house / reference << "%)\n";
+    std::cout << "checksum: " << sink << "\n";
+    return 0;
+}
+
+// Plain min/max over every piece and placement, to check the analyzer's pruning and memo
+static int naiveSurvival(const Board& board, int depth) {
+    if (depth == 0 || spawnAreaFilled(board)) return 0;
+    int worst = depth;
+    for (int t = 0; t < PIECE_TYPES; t++) {
+        Placement placements[MAX_PLACEMENTS];
+        int count = enumeratePlacements(board, static_cast<Tetromino::Type>(t), placements);
+        int best = 0;
+        for (int i = 0; i < count; i++) {
+            Board child = applyPlacement(board, placements[i]);
+            child.clearLines();
+            best = std::max(best, 1 + naiveSurvival(child, depth - 1));
+        }
+        worst = std::min(worst, best);
+    }
+    return worst;
+}
+
+// The same min/max with every (board, depth) remembered and no alpha-beta bounds, so it's exact
+// and fast enough to check the analyzer at the depths where its memo bounds matter
+static int exactSurvival(const Board& board, int depth, std::unordered_map<std::string, int>& memo) {
+    if (depth == 0 || spawnAreaFilled(board)) return 0;
+    std::string key(reinterpret_cast<const char*>(board.rows), sizeof(board.rows));
+    key.push_back(static_cast<char>(depth));
+    auto found = memo.find(key);
+    if (found != memo.end()) return found->second;
+
+    int worst = depth;
+    for (int t = 0; t < PIECE_TYPES; t++) {
+        Placement placements[MAX_PLACEMENTS];
+        int count = enumeratePlacements(board, static_cast<Tetromino::Type>(t), placements);
+        // Stopping at the most or least a value can be is still exact
+        int best = 0;
+        for (int i = 0; i < count && best < depth; i++) {
+            Board child = applyPlacement(board, placements[i]);
+            child.clearLines();
+            best = std::max(best, 1 + exactSurvival(child, depth - 1, memo));
+        }
+        worst = std::min(worst, best);
+        if (worst == 0) break;
+    }
+    memo[key] = worst;
+    return worst;
+}
+
+// Stack reaching close to the spawn area, with the sides higher than the middle, so the
+// player has few safe placements and the adversary often forces a top-out
+static Board crowdedBoard(std::mt19937& rng) {
+    Board board;
+    for (int x = 0; x < GRID_WIDTH; x++) {
+        bool middle = x >= 3 && x <= 6;
+        int top = middle ? 4 + rng() % 5 : rng() % 7;
+        for (int y = top; y < GRID_HEIGHT; y++) {
+            if (y == top || rng() % 5 != 0) board.rows[y] |= 1u << x;
+        }
+    }
+    board.clearLines();
+    return board;
+}
+
+static int benchSurvival() {
+    std::mt19937 rng(5);
+    std::vector<Board> crowded(400);
+    for (Board& board : crowded) {
+        board = crowdedBoard(rng);
+    }
+
+    // The memo carries over between boards and depths, which is part of what's checked
+    SurvivalAnalyzer single(1);
+    int threads = static_cast<int>(std::thread::hardware_concurrency());
+    SurvivalAnalyzer parallel(threads > 1 ? threads : 2);
+    for (int i = 0; i < 40; i++) {
+        int depth = 2 + i % 2;
+        int expected = naiveSurvival(crowded[i], depth);
+        SurvivalResult a = single.analyze(crowded[i], depth);
+        SurvivalResult b = parallel.analyze(crowded[i], depth);
+        if (a.pieces != expected || b.pieces != expected) {
+            std::cerr << "survival mismatch on board " << i << " at depth " << depth << ": naive " << expected
+                      << ", analyzer " << a.pieces << ", parallel " << b.pieces << "\n";
+            return 1;
+        }
+    }
+
+    // Deeper, where bounds from cut-off searches get reused, against fresh analyzers too
+    std::mt19937 deepRng(11);
+    std::unordered_map<std::string, int> memo;
+    for (int i = 0; i < 24; i++) {
+        Board board = crowdedBoard(deepRng);
+        for (int depth = 4; depth <= 5; depth++) {
+            int expected = exactSurvival(board, depth, memo);
+            SurvivalAnalyzer fresh(1);
+            int values[3] = {single.analyze(board, depth).pieces, parallel.analyze(board, depth).pieces,
+                             fresh.analyze(board, depth).pieces};
+            for (int value : values) {
+                if (value != expected) {
+                    std::cerr << "survival mismatch on deep board " << i << " at depth " << depth << ": exact "
+                              << expected << ", analyzers " << values[0] << " " << values[1] << " " << values[2] << "\n";
+                    return 1;
+                }
+            }
+        }
+    }
+
+    struct Set { const char* name; std::vector<Board> boards; };
+    Set sets[] = {{"crowded", crowded}, {"played", sampleBoards(400, 77)}};
+    for (const Set& set : sets) {
+        for (int depth = 2; depth <= 5; depth++) {
+            single.clearMemo();
+            long long nodes = 0;
+            int histogram[SURVIVAL_MAX_DEPTH + 1] = {};
+            double slowest = 0;
+            auto start = Clock::now();
+            for (const Board& board : set.boards) {
+                SurvivalResult result = single.analyze(board, depth);
+                nodes += result.nodes;
+                histogram[result.pieces]++;
+                slowest = std::max(slowest, result.seconds);
+            }
+            double seconds = secondsSince(start);
+            size_t positions = set.boards.size();
+            std::cout << "survival " << set.name << " depth " << depth << ": " << seconds * 1e3 / positions
+                      << " ms per position (slowest " << slowest * 1e3 << " ms), " << nodes / positions
+                      << " nodes; pieces survived:";
+            for (int v = 0; v <= depth; v++) {
+                std::cout << " " << v << "=" << histogram[v];
+            }
+            std::cout << "\n";
+        }
+    }
+    return 0;
+}
+
+// Value of each next piece the way AdversarialChooser defines it, one board at a time
+static void naiveAdversaryValues(const Board& board, Tetromino::Type current, float* values) {
+    EvalWeights weights;
+    BoardSet set;
+    BoardFeatures features;
+    Placement placements[MAX_PLACEMENTS];
+    int count = enumeratePlacements(board, current, placements);
+    for (int t = 0; t < PIECE_TYPES; t++) {
+        values[t] = -1e30f;
+        for (int i = 0; i < count; i++) {
+            Board child = applyPlacement(board, placements[i]);
+            float cleared = weights.lines * child.clearLines();
+            Placement replies[MAX_PLACEMENTS];
+            int replyCount = enumeratePlacements(child, static_cast<Tetromino::Type>(t), replies);
+            for (int j = 0; j < replyCount; j++) {
+                set.clear();
+                set.add(applyPlacement(child, replies[j]));
+                evaluateBoardsScalar(set, features);
+                values[t] = std::max(values[t], cleared + scoreFeatures(features, 0, weights));
+            }
+        }
+    }
+}
+
+// Pieces a search bot places before topping out, capped at maxPieces
+template <typename Engine>
+static uint32_t botGame(Engine& engine, uint32_t maxPieces) {
+    uint32_t planned = 0;
+    Placement target = {};
+    int steps = 0;
+    while (engine.gameState == GameState::PLAYING && engine.pieces <= maxPieces) {
+        if (engine.pieces != planned) {
+            planned = engine.pieces;
+            steps = 0;
+            target = findBestPlacement(Board::fromGrid(engine.grid), engine.currentPiece.type).placement;
+        }
+        engine.tick(++steps > PILOT_MAX_STEPS ? Input::HARD_DROP : pilotInput(engine, target));
+    }
+    return engine.pieces - 1;
+}
+
+static int benchAdversary() {
+    // The pick must be the naive ranking's worst, second or third piece, as the roll says
+    std::vector<Board> boards = sampleBoards(60, 31);
+    AdversarialChooser exact(1000000);
+    for (size_t i = 0; i < boards.size(); i++) {
+        Tetromino::Type current = static_cast<Tetromino::Type>(i % PIECE_TYPES);
+        if (spawnBlocked(boards[i], current)) continue;
+        float values[PIECE_TYPES];
+        naiveAdversaryValues(boards[i], current, values);
+        int order[PIECE_TYPES];
+        for (int t = 0; t < PIECE_TYPES; t++) order[t] = t;
+        std::stable_sort(order, order + PIECE_TYPES, [&](int a, int b) { return values[a] < values[b]; });
+
+        PieceRandom random;
+        random.seed(static_cast<uint32_t>(i + 1));
+        PieceRandom peek = random;
+        int roll = static_cast<int>(peek.next() % 100);
+        int rank = roll < ADVERSARY_PICK_PERCENT[0] ? 0 : roll < ADVERSARY_PICK_PERCENT[0] + ADVERSARY_PICK_PERCENT[1] ? 1 : 2;
+        Tetromino::Type choice = exact.choosePiece(boards[i], current, random);
+        if (static_cast<int>(choice) != order[rank]) {
+            std::cerr << "adversary picked piece " << static_cast<int>(choice) << " on board " << i
+                      << ", naive ranking says " << order[rank] << "\n";
+            return 1;
+        }
+    }
+    if (exact.stats.fallbacks != 0) {
+        std::cerr << "adversary fell back to random with a one-second budget\n";
+        return 1;
+    }
+
+    // Out of time on every decision: plain random pieces, game still playable
+    AdversarialChooser starved(0);
+    TetrisEngine starvedGame(7);
+    starvedGame.chooser = &starved;
+    botGame(starvedGame, 200);
+    if (starved.stats.decisions == 0 || starved.stats.fallbacks + starved.stats.blocked != starved.stats.decisions) {
+        std::cerr << "zero budget: " << starved.stats.fallbacks << " of " << starved.stats.decisions
+                  << " decisions fell back\n";
+        return 1;
+    }
+
+    // Nowhere to drop the current piece isn't a budget miss
+    Board walled;
+    for (int y = 0; y < GRID_HEIGHT; y++) {
+        walled.rows[y] = FULL_ROW;
+    }
+    PieceRandom random;
+    random.seed(3);
+    exact.choosePiece(walled, Tetromino::Type::T, random);
+    if (exact.stats.fallbacks != 0 || exact.stats.blocked != 1) {
+        std::cerr << "a board with no placements counted as " << exact.stats.fallbacks << " budget misses\n";
+        return 1;
+    }
+
+    // The same bot against random and adversarial pieces
+    const int games = 20;
+    const uint32_t maxPieces = 5000;
+    AdversarialChooser chooser;
+    long long randomPieces = 0, adversaryPieces = 0;
+    auto start = Clock::now();
+    for (int g = 0; g < games; g++) {
+        TetrisEngine random(100 + g);
+        randomPieces += botGame(random, maxPieces);
+        TetrisEngine adversary(100 + g);
+        adversary.chooser = &chooser;
+        adversaryPieces += botGame(adversary, maxPieces);
+    }
+    double seconds = secondsSince(start);
+    const ChooserStats& stats = chooser.stats;
+    std::cout << "adversary: " << stats.decisions << " decisions, " << stats.totalSeconds * 1e6 / stats.decisions
+              << " us average, " << stats.maxSeconds * 1e6 << " us slowest (budget " << ADVERSARY_BUDGET_US
+              << " us), " << stats.fallbacks << " over budget, " << stats.blocked << " with no placements\n"
+              << "bot survives " << randomPieces / games << " pieces with random pieces (cap " << maxPieces
+              << "), " << adversaryPieces / games << " against the adversary (" << seconds << " s)\n";
+    return 0;
+}
+
+// Engine states from bot games, every few ticks, so records hold real stacks and pieces
+template <typename Engine>
+static std::vector<Engine> sampleEngines(int count, uint32_t seed) {
+    std::vector<Engine> states;
+    PieceRandom noise;
+    noise.seed(seed);
+    Engine engine(seed);
+    uint32_t planned = 0;
+    Placement target = {};
+    int steps = 0;
+    while (static_cast<int>(states.size()) < count) {
+        if (engine.gameState != GameState::PLAYING) {
+            states.push_back(engine);
+            engine.reset(noise.next());
+        }
+        if (engine.pieces != planned) {
+            planned = engine.pieces;
+            steps = 0;
+            target = findBestPlacement(Board::fromGrid(engine.grid), engine.currentPiece.type).placement;
+        }
+        // Some idle frames and rotations so pieces are caught mid-fall and turned
+        uint32_t roll = noise.next() % 8;
+        Input input = roll < 3 ? Input::NONE : roll == 3 ? Input::ROTATE : ++steps > PILOT_MAX_STEPS ? Input::HARD_DROP : pilotInput(engine, target);
+        engine.tick(input);
+        if (roll == 4) states.push_back(engine);
+    }
+    return states;
+}
+
+// A packed and restored engine must hash the same, agree on what the hash leaves out and
+// play on identically
+template <typename Engine>
+static bool checkRoundTrip(const std::vector<Engine>& states, const char* name) {
+    SessionStore<Engine> store;
+    for (size_t i = 0; i < states.size(); i++) {
+        const Engine& original = states[i];
+        uint32_t id = store.dehydrate(original);
+        Engine restored;
+        store.hydrate(id, restored);
+        bool same = hashState(original) == hashState(restored) && original.ticks == restored.ticks &&
+                    original.pieces == restored.pieces && original.rotation == restored.rotation &&
+                    original.linesJustCleared == restored.linesJustCleared &&
+                    original.nextPiece.color == restored.nextPiece.color &&
+                    std::memcmp(&original.nextPiece.shape, &restored.nextPiece.shape, sizeof(Tetromino::Shape)) == 0;
+        Engine a = original;
+        for (int t = 0; t < 300 && same; t++) {
+            Input input = static_cast<Input>((i * 7 + t * 13) % INPUT_COUNT);
+            a.tick(input);
+            restored.tick(input);
+            same = hashState(a) == hashState(restored);
+        }
+        if (!same) {
+            std::cerr << name << " state " << i << " doesn't survive dehydrate/hydrate\n";
+            return false;
+        }
+        if (i % 3 == 0) store.release(id);
+    }
+    return true;
+}
+
+static int benchSessions() {
+    std::vector<TetrisEngine> states = sampleEngines<TetrisEngine>(4096, 21);
+    if (!checkRoundTrip(states, "classic") || !checkRoundTrip(sampleEngines<GuidelineEngine>(2048, 22), "guideline") ||
+        !checkRoundTrip(sampleEngines<HouseEngine>(2048, 23), "house")) {
+        return 1;
+    }
+
+    const uint32_t sessions = 1000000;
+    SessionStore<TetrisEngine> store(sessions);
+    std::vector<uint32_t> ids(sessions);
+    auto start = Clock::now();
+    for (uint32_t i = 0; i < sessions; i++) {
+        ids[i] = store.dehydrate(states[i % states.size()]);
+    }
+    double dehydrate = secondsSince(start);
+    // Again into records already paged in
+    start = Clock::now();
+    for (uint32_t i = 0; i < sessions; i++) {
+        store.update(ids[i], states[(i + 5) % states.size()]);
+    }
+    double update = secondsSince(start);
+    for (uint32_t i = 0; i < sessions; i++) {
+        store.update(ids[i], states[i % states.size()]);
+    }
+
+    // Random order, as sessions would wake up
+    std::mt19937 rng(9);
+    std::vector<uint32_t> order(ids);
+    std::shuffle(order.begin(), order.end(), rng);
+    TetrisEngine game;
+    long long sink = 0;
+    start = Clock::now();
+    for (uint32_t id : order) {
+        store.hydrate(id, game);
+        sink += game.score;
+    }
+    double hydrate = secondsSince(start);
+
+    long long expected = 0;
+    for (uint32_t i = 0; i < sessions; i++) {
+        expected += states[i % states.size()].score;
+    }
+    if (sink != expected) {
+        std::cerr << "hydrated scores add up to " << sink << ", expected " << expected << "\n";
+        return 1;
+    }
+
+    // Half the sessions end and new ones take their records; the slab must not grow
+    size_t bytes = store.bytes();
+    for (uint32_t i = 0; i < sessions; i += 2) {
+        store.release(ids[i]);
+    }
+    for (uint32_t i = 0; i < sessions; i += 2) {
+        ids[i] = store.dehydrate(states[(i + 1) % states.size()]);
+    }
+    if (store.bytes() != bytes || store.size() != sessions) {
+        std::cerr << "slab grew from " << bytes << " to " << store.bytes() << " bytes while reusing records\n";
+        return 1;
+    }
+
+    // Releasing twice, or an id that was never handed out, must leave the free list alone
+    uint32_t reused = ids[0];
+    if (!store.release(reused) || store.release(reused) || store.release(sessions) || store.size() != sessions - 1 ||
+        store.dehydrate(states[0]) != reused || store.dehydrate(states[1]) == reused) {
+        std::cerr << "a double or stale release put a record on the free list twice\n";
+        return 1;
+    }
+
+    std::cout << "sessions: " << sessions << " in " << bytes / 1e6 << " MB, " << double(bytes) / sessions
+              << " bytes per idle session (active engine " << sizeof(TetrisEngine) << " bytes)\n"
+              << "dehydrate: " << dehydrate * 1e9 / sessions << " ns (" << update * 1e9 / sessions
+              << " ns into touched records), hydrate (random order): "
+              << hydrate * 1e9 / sessions << " ns per session\n";
+    return 0;
+}
+
+struct Benchmark {
+    const char* name;
+    int (*run)();
+};
+
+static const Benchmark benchmarks[] = {
+    {"eval", benchEval},
+    {"nnue", benchNnue},
+    {"env", benchEnv},
+    {"rules", benchRules},
+    {"survival", benchSurvival},
+    {"adversary", benchAdversary},
+    {"sessions", benchSessions},
+};
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cout << "benchmarks:";
+        for (const Benchmark& benchmark : benchmarks) {
+            std::cout << " " << benchmark.name;
+        }
+        std::cout << "\n";
+        return 0;
+    }
+    std::string name = argv[1];
+    for (const Benchmark& benchmark : benchmarks) {
+        if (name == benchmark.name) {
+            return benchmark.run();
+        }
+    }
+    std::cerr << "unknown benchmark: " << name << "\n";
+    return 1;
+}
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <cstdint>
+#include "tetromino.h"
+
+// Bitboard view of the playfield used by the AI code.
+// Row 0 is the top of the grid (same as TetrisEngine::grid), bit x is column x.
+const uint16_t FULL_ROW = (1u << GRID_WIDTH) - 1;
+const int PIECE_TYPES = 7;
+const int MAX_ROTATIONS = 4;
+const int MAX_PLACEMENTS = MAX_ROTATIONS * GRID_WIDTH;
+
+// Spawn position used by TetrisEngine::spawnNewPiece()
+const int SPAWN_X = GRID_WIDTH / 2 - 1;
+const int SPAWN_Y = 0;
+
+struct Board {
+    uint16_t rows[GRID_HEIGHT];
+
+    Board() {
+        clear();
+    }
+
+    void clear() {
+        for (int y = 0; y < GRID_HEIGHT; y++) {
+            rows[y] = 0;
+        }
+    }
+
+    // Works for TetrisEngine's fixed grid and any other grid[y][x] of color values
+    template <typename Grid>
+    static Board fromGrid(const Grid& grid) {
+        Board board;
+        for (int y = 0; y < GRID_HEIGHT; y++) {
+            for (int x = 0; x < GRID_WIDTH; x++) {
+                if (grid[y][x] != 0) {
+                    board.rows[y] |= 1u << x;
+                }
+            }
+        }
+        return board;
+    }
+
+    bool filled(int x, int y) const {
+        return (rows[y] >> x) & 1;
+    }
+
+    bool empty() const {
+        for (int y = 0; y < GRID_HEIGHT; y++) {
+            if (rows[y] != 0) return false;
+        }
+        return true;
+    }
+
+    // Removes full rows and shifts everything above down, like TetrisEngine::clearLines()
+    int clearLines() {
+        int cleared = 0;
+        int write = GRID_HEIGHT - 1;
+        for (int read = GRID_HEIGHT - 1; read >= 0; --read) {
+            if (rows[read] == FULL_ROW) {
+                cleared++;
+                continue;
+            }
+            rows[write--] = rows[read];
+        }
+        while (write >= 0) {
+            rows[write--] = 0;
+        }
+        return cleared;
+    }
+
+    bool operator==(const Board& other) const {
+        for (int y = 0; y < GRID_HEIGHT; y++) {
+            if (rows[y] != other.rows[y]) return false;
+        }
+        return true;
+    }
+};
+
+// Notified by TetrisEngine as it changes the grid, so state derived from the grid
+// can be updated in step instead of being rebuilt
+class GridListener {
+public:
+    virtual ~GridListener() {}
+    virtual void gridReset() = 0;
+    virtual void cellSet(int x, int y) = 0;
+    // `before` is the grid just before full row `row` is removed and the rows above drop
+    virtual void rowCleared(const Board& before, int row) = 0;
+};
+
+// One rotation of a piece as row masks, normalized so its top-left cell box starts at (0, 0)
+struct PieceShape {
+    uint16_t rows[4];
+    int width;
+    int height;
+    Tetromino::Position blocks[4];
+};
+
+// Row masks of a shape moved so its bounding box starts at (0, 0).
+// minX/minY report how far the original blocks were offset from there.
+inline PieceShape makePieceShape(const Tetromino::Shape& blocks, int& minX, int& minY) {
+    minX = INT_MAX;
+    minY = INT_MAX;
+    int maxX = INT_MIN, maxY = INT_MIN;
+    for (const auto& block : blocks) {
+        minX = std::min(minX, block.x);
+        maxX = std::max(maxX, block.x);
+        minY = std::min(minY, block.y);
+        maxY = std::max(maxY, block.y);
+    }
+
+    PieceShape shape = {};
+    shape.width = maxX - minX + 1;
+    shape.height = maxY - minY + 1;
+    for (int i = 0; i < 4; i++) {
+        int x = blocks[i].x - minX;
+        int y = blocks[i].y - minY;
+        shape.rows[y] |= 1u << x;
+        shape.blocks[i] = {x, y};
+    }
+    return shape;
+}
+
+inline bool samePieceShape(const PieceShape& a, const PieceShape& b) {
+    if (a.width != b.width || a.height != b.height) return false;
+    for (int y = 0; y < 4; y++) {
+        if (a.rows[y] != b.rows[y]) return false;
+    }
+    return true;
+}
+
+// All distinct rotations of every piece type.
+// Rotations come from Tetromino::rotate() so the AI sees the same shapes the player does.
+struct PieceTable {
+    PieceShape shapes[PIECE_TYPES][MAX_ROTATIONS];
+    int rotations[PIECE_TYPES];
+    PieceShape spawn[PIECE_TYPES];
+    int spawnOffsetX[PIECE_TYPES];
+    int spawnOffsetY[PIECE_TYPES];
+
+    PieceTable() {
+        for (int t = 0; t < PIECE_TYPES; t++) {
+            Tetromino piece(static_cast<Tetromino::Type>(t));
+            rotations[t] = 0;
+
+            // Spawn shape is kept un-normalized so spawn collision matches the game exactly
+            int minX, minY;
+            spawn[t] = makePieceShape(piece.shape, minX, minY);
+            spawnOffsetX[t] = minX;
+            spawnOffsetY[t] = minY;
+
+            for (int r = 0; r < MAX_ROTATIONS; r++) {
+                int ignoredX, ignoredY;
+                PieceShape shape = makePieceShape(piece.shape, ignoredX, ignoredY);
+                bool duplicate = false;
+                for (int i = 0; i < rotations[t]; i++) {
+                    if (samePieceShape(shapes[t][i], shape)) {
+                        duplicate = true;
+                        break;
+                    }
+                }
+                if (!duplicate) {
+                    shapes[t][rotations[t]++] = shape;
+                }
+                piece.rotate();
+            }
+        }
+    }
+};
+
+inline const PieceTable& pieceTable() {
+    static const PieceTable table;
+    return table;
+}
+
+inline bool shapeFits(const Board& board, const PieceShape& shape, int x, int y) {
+    if (x < 0 || x + shape.width > GRID_WIDTH || y < 0 || y + shape.height > GRID_HEIGHT) {
+        return false;
+    }
+    for (int row = 0; row < shape.height; row++) {
+        if (board.rows[y + row] & (shape.rows[row] << x)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+inline void placeShape(Board& board, const PieceShape& shape, int x, int y) {
+    for (int row = 0; row < shape.height; row++) {
+        board.rows[y + row] |= static_cast<uint16_t>(shape.rows[row] << x);
+    }
+}
+
+// True when a freshly spawned piece of this type would overlap the stack (game over)
+inline bool spawnBlocked(const Board& board, Tetromino::Type type) {
+    const PieceTable& table = pieceTable();
+    int t = static_cast<int>(type);
+    return !shapeFits(board, table.spawn[t], SPAWN_X + table.spawnOffsetX[t], SPAWN_Y + table.spawnOffsetY[t]);
+}
+
+// A landing spot: rotation index into PieceTable, column of the leftmost cell and resting row
+struct Placement {
+    uint8_t type;
+    uint8_t rotation;
+    int8_t x;
+    int8_t y;
+};
+
+// Drops the shape straight down from the top of column x.
+// Returns the resting row, or -1 when the piece can't even enter at the top.
+inline int dropRow(const Board& board, const PieceShape& shape, int x) {
+    if (!shapeFits(board, shape, x, 0)) {
+        return -1;
+    }
+    int y = 0;
+    while (shapeFits(board, shape, x, y + 1)) {
+        y++;
+    }
+    return y;
+}
+
+// Fills out[] with every hard-drop landing of the piece and returns how many there are
+inline int enumeratePlacements(const Board& board, Tetromino::Type type, Placement* out) {
+    const PieceTable& table = pieceTable();
+    int t = static_cast<int>(type);
+    int count = 0;
+    for (int r = 0; r < table.rotations[t]; r++) {
+        const PieceShape& shape = table.shapes[t][r];
+        for (int x = 0; x + shape.width <= GRID_WIDTH; x++) {
+            int y = dropRow(board, shape, x);
+            if (y < 0) continue;
+            out[count++] = {static_cast<uint8_t>(t), static_cast<uint8_t>(r),
+                            static_cast<int8_t>(x), static_cast<int8_t>(y)};
+        }
+    }
+    return count;
+}
+
+// Board after locking the placement, before any line clears
+inline Board applyPlacement(const Board& board, const Placement& placement) {
+    Board result = board;
+    placeShape(result, pieceTable().shapes[placement.type][placement.rotation], placement.x, placement.y);
+    return result;
+}
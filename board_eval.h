@@ -0,0 +1,235 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include "board.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define TETRIS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(TETRIS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TETRIS_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TETRIS_TARGET_AVX2
+#endif
+
+// Boards are evaluated in blocks of 16: one AVX2 register holds the same row of 16 boards
+const int BOARD_LANES = 16;
+const int BOARD_SET_CAPACITY = ((MAX_PLACEMENTS + BOARD_LANES - 1) / BOARD_LANES) * BOARD_LANES;
+
+// Structure-of-arrays batch of boards: rows[y][i] is row y of board i.
+// Boards are stored before line clears; the evaluator accounts for full rows itself.
+struct BoardSet {
+    alignas(32) uint16_t rows[GRID_HEIGHT][BOARD_SET_CAPACITY];
+    int count;
+
+    BoardSet() : count(0) {
+        std::memset(rows, 0, sizeof(rows));
+    }
+
+    // Lanes past count still get evaluated with the rest of their block; their results
+    // are never read, so stale rows there are harmless and don't need zeroing
+    void clear() {
+        count = 0;
+    }
+
+    int add(const Board& board) {
+        int i = count++;
+        for (int y = 0; y < GRID_HEIGHT; y++) {
+            rows[y][i] = board.rows[y];
+        }
+        return i;
+    }
+
+    Board get(int i) const {
+        Board board;
+        for (int y = 0; y < GRID_HEIGHT; y++) {
+            board.rows[y] = rows[y][i];
+        }
+        return board;
+    }
+};
+
+// Features of each board in a BoardSet, measured after its full rows are cleared
+struct BoardFeatures {
+    alignas(32) int16_t aggregateHeight[BOARD_SET_CAPACITY];
+    alignas(32) int16_t maxHeight[BOARD_SET_CAPACITY];
+    alignas(32) int16_t holes[BOARD_SET_CAPACITY];
+    alignas(32) int16_t bumpiness[BOARD_SET_CAPACITY];
+    alignas(32) int16_t lines[BOARD_SET_CAPACITY];
+};
+
+// Heuristic weights (aggregate height, lines, holes, bumpiness), tuned by Yiyuan Lee's "El-Tetris"
+struct EvalWeights {
+    float aggregateHeight = -0.510066f;
+    float lines = 0.760666f;
+    float holes = -0.35663f;
+    float bumpiness = -0.184483f;
+};
+
+inline int popcount16(uint16_t value) {
+    unsigned v = value;
+    v = v - ((v >> 1) & 0x5555);
+    v = (v & 0x3333) + ((v >> 2) & 0x3333);
+    v = (v + (v >> 4)) & 0x0f0f;
+    return (v + (v >> 8)) & 0x1f;
+}
+
+// Reference implementation, one board at a time.
+//
+// Full rows are skipped, which is the same as measuring the board after clearLines().
+// "seen" accumulates every cell at or above the current row, so a column counts towards
+// its height on every row from its top cell down. Holes are empty cells under "seen".
+// Adjacent-column height differences equal the rows where seen differs between the two
+// columns, which lets bumpiness come from a shift and xor instead of per-column heights.
+inline void evaluateBoardsScalar(const BoardSet& set, BoardFeatures& out) {
+    int blocks = (set.count + BOARD_LANES - 1) / BOARD_LANES;
+    for (int i = 0; i < blocks * BOARD_LANES; i++) {
+        uint16_t seen = 0;
+        int height = 0, maxHeight = 0, holes = 0, bumpiness = 0, lines = 0;
+        for (int y = 0; y < GRID_HEIGHT; y++) {
+            uint16_t row = set.rows[y][i];
+            if (row == FULL_ROW) {
+                lines++;
+                continue;
+            }
+            seen |= row;
+            height += popcount16(seen);
+            holes += popcount16(seen & ~row);
+            bumpiness += popcount16((seen ^ (seen >> 1)) & (FULL_ROW >> 1));
+            maxHeight += seen != 0;
+        }
+        out.aggregateHeight[i] = static_cast<int16_t>(height);
+        out.maxHeight[i] = static_cast<int16_t>(maxHeight);
+        out.holes[i] = static_cast<int16_t>(holes);
+        out.bumpiness[i] = static_cast<int16_t>(bumpiness);
+        out.lines[i] = static_cast<int16_t>(lines);
+    }
+}
+
+#ifdef TETRIS_X86
+// Per-lane popcount of 16-bit values using the nibble lookup trick
+TETRIS_TARGET_AVX2 inline __m256i popcount16x16(__m256i v) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibble = _mm256_set1_epi8(0x0f);
+    __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, lowNibble));
+    __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), lowNibble));
+    __m256i bytes = _mm256_add_epi8(lo, hi);
+    // Fold the two byte counts of every 16-bit lane together
+    return _mm256_srli_epi16(_mm256_mullo_epi16(bytes, _mm256_set1_epi16(0x0101)), 8);
+}
+
+// Same math as evaluateBoardsScalar(), 16 boards per instruction
+TETRIS_TARGET_AVX2 inline void evaluateBoardsAVX2(const BoardSet& set, BoardFeatures& out) {
+    const __m256i full = _mm256_set1_epi16(FULL_ROW);
+    const __m256i bumpMask = _mm256_set1_epi16(FULL_ROW >> 1);
+    const __m256i zero = _mm256_setzero_si256();
+
+    int blocks = (set.count + BOARD_LANES - 1) / BOARD_LANES;
+    for (int b = 0; b < blocks; b++) {
+        int base = b * BOARD_LANES;
+        __m256i seen = zero;
+        __m256i height = zero, maxHeight = zero, holes = zero, bumpiness = zero, lines = zero;
+        for (int y = 0; y < GRID_HEIGHT; y++) {
+            __m256i row = _mm256_load_si256(reinterpret_cast<const __m256i*>(&set.rows[y][base]));
+            // Comparisons give -1 for true, so subtracting counts the matches
+            __m256i isFull = _mm256_cmpeq_epi16(row, full);
+            lines = _mm256_sub_epi16(lines, isFull);
+            seen = _mm256_or_si256(seen, _mm256_andnot_si256(isFull, row));
+            // Full rows are masked out of every count instead of branching per lane
+            __m256i counted = _mm256_andnot_si256(isFull, seen);
+            height = _mm256_add_epi16(height, popcount16x16(counted));
+            holes = _mm256_add_epi16(holes, popcount16x16(_mm256_andnot_si256(row, counted)));
+            __m256i steps = _mm256_and_si256(_mm256_xor_si256(counted, _mm256_srli_epi16(counted, 1)), bumpMask);
+            bumpiness = _mm256_add_epi16(bumpiness, popcount16x16(steps));
+            maxHeight = _mm256_sub_epi16(maxHeight, _mm256_andnot_si256(_mm256_cmpeq_epi16(counted, zero), _mm256_set1_epi16(-1)));
+        }
+        _mm256_store_si256(reinterpret_cast<__m256i*>(&out.aggregateHeight[base]), height);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(&out.maxHeight[base]), maxHeight);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(&out.holes[base]), holes);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(&out.bumpiness[base]), bumpiness);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(&out.lines[base]), lines);
+    }
+}
+
+inline bool cpuHasAVX2() {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+#endif
+
+typedef void (*EvaluateBoardsFn)(const BoardSet&, BoardFeatures&);
+
+// Picks the fastest evaluator this CPU supports, checked once
+inline EvaluateBoardsFn selectBoardEvaluator() {
+#ifdef TETRIS_X86
+    if (cpuHasAVX2()) return evaluateBoardsAVX2;
+#endif
+    return evaluateBoardsScalar;
+}
+
+inline void evaluateBoards(const BoardSet& set, BoardFeatures& out) {
+    static const EvaluateBoardsFn evaluate = selectBoardEvaluator();
+    evaluate(set, out);
+}
+
+inline float scoreFeatures(const BoardFeatures& features, int i, const EvalWeights& weights) {
+    return weights.aggregateHeight * features.aggregateHeight[i]
+         + weights.lines * features.lines[i]
+         + weights.holes * features.holes[i]
+         + weights.bumpiness * features.bumpiness[i];
+}
+
+// Result of a placement search: the chosen landing and its heuristic score
+struct SearchResult {
+    Placement placement;
+    float score;
+    bool found;
+};
+
+// Evaluates every landing of the piece in one batch and returns the best one
+inline SearchResult findBestPlacement(const Board& board, Tetromino::Type type,
+                                      const EvalWeights& weights = EvalWeights(),
+                                      EvaluateBoardsFn evaluate = evaluateBoards) {
+    Placement placements[MAX_PLACEMENTS];
+    int count = enumeratePlacements(board, type, placements);
+
+    static thread_local BoardSet set;
+    static thread_local BoardFeatures features;
+    set.clear();
+    for (int i = 0; i < count; i++) {
+        set.add(applyPlacement(board, placements[i]));
+    }
+    evaluate(set, features);
+
+    SearchResult result = {};
+    result.found = false;
+    for (int i = 0; i < count; i++) {
+        float score = scoreFeatures(features, i, weights);
+        if (!result.found || score > result.score) {
+            result.placement = placements[i];
+            result.score = score;
+            result.found = true;
+        }
+    }
+    return result;
+}
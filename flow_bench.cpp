@@ -0,0 +1,115 @@
+// Stress test for game_flow.h: thousands of coroutine games on one thread, each fed
+// by a coroutine "player" that presses a key every 80-400 ms of game time, presses R
+// after a game over and, one time in ten, quits instead. The clock is simulated, so
+// this measures only what the scheduler and the games cost.
+// Build: g++ -O2 -std=c++20 flow_bench.cpp -o flow_bench
+// Usage: flow_bench [games=10000] [game seconds=120]
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <vector>
+#include "game_flow.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static const Input PLAYER_INPUTS[8] = {
+    Input::LEFT, Input::RIGHT, Input::ROTATE, Input::LEFT, Input::RIGHT, Input::ROTATE, Input::SOFT_DROP, Input::HARD_DROP,
+};
+
+static FlowTask randomPlayer(FlowScheduler& scheduler, InputChannel& inputs, const TetrisEngine& engine,
+                             uint32_t seed) {
+    PieceRandom random;
+    random.seed(seed);
+    for (;;) {
+        co_await scheduler.sleepFor(80 + random.next() % 320);
+        if (engine.gameState == GameState::PLAYING) {
+            inputs.push(PLAYER_INPUTS[random.next() % 8]);
+            continue;
+        }
+        // A moment on the game-over screen, then a keypress that isn't R, which must be ignored
+        co_await scheduler.sleepFor(1000 + random.next() % 2000);
+        inputs.push(Input::HARD_DROP);
+        if (random.next() % 10 == 0) {
+            inputs.push(FlowCommand::QUIT);
+            co_return;
+        }
+        inputs.push(FlowCommand::RESTART);
+    }
+}
+
+// Same waking pattern with no game behind it, to see the scheduler on its own
+static FlowTask idleLoop(FlowScheduler& scheduler, uint32_t seed) {
+    PieceRandom random;
+    random.seed(seed);
+    for (;;) {
+        co_await scheduler.sleepFor(80 + random.next() % 320);
+    }
+}
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    int games = argc > 1 ? std::atoi(argv[1]) : 10000;
+    uint64_t horizon = (argc > 2 ? std::atoi(argv[2]) : 120) * 1000ull;
+
+    {
+        FlowScheduler scheduler(games * 4);
+        // Engines and channels never move once the coroutines hold references to them
+        std::vector<TetrisEngine> engines(games);
+        std::deque<InputChannel> channels;
+        std::vector<FlowStats> stats(games);
+        std::vector<FlowTask> tasks;
+        tasks.reserve(games * 2);
+        for (int i = 0; i < games; i++) {
+            channels.emplace_back(scheduler);
+            tasks.push_back(playGame(scheduler, engines[i], channels[i], 1000 + i, stats[i]));
+            tasks.push_back(randomPlayer(scheduler, channels[i], engines[i], 7 + i));
+        }
+        for (const FlowTask& task : tasks) {
+            scheduler.start(task);
+        }
+
+        auto start = Clock::now();
+        scheduler.runUntil(horizon);
+        double seconds = secondsSince(start);
+
+        FlowStats total;
+        int quit = 0;
+        for (int i = 0; i < games; i++) {
+            total.inputs += stats[i].inputs;
+            total.gravitySteps += stats[i].gravitySteps;
+            total.games += stats[i].games;
+            quit += stats[i].quit;
+            if (stats[i].quit != tasks[2 * i].done()) {
+                std::cerr << "game " << i << " quit without its flow returning, or the other way round\n";
+                return 1;
+            }
+        }
+        uint64_t gameTicks = total.inputs + total.gravitySteps;
+        std::cout << games << " games for " << horizon / 1000 << " s of game time on one thread: "
+                  << seconds << " s wall (" << horizon / 1000.0 / seconds << "x real time)\n"
+                  << "    " << gameTicks << " game ticks (" << total.inputs << " inputs, " << total.gravitySteps
+                  << " gravity steps), " << total.games << " games finished, " << quit << " players quit\n"
+                  << "    " << scheduler.resumes() << " resumes, " << seconds * 1e9 / scheduler.resumes()
+                  << " ns per resume, " << seconds * 1e9 / gameTicks << " ns per game tick\n";
+    }
+
+    {
+        FlowScheduler scheduler(games);
+        std::vector<FlowTask> tasks;
+        tasks.reserve(games);
+        for (int i = 0; i < games; i++) {
+            tasks.push_back(idleLoop(scheduler, 7 + i));
+            scheduler.start(tasks.back());
+        }
+        auto start = Clock::now();
+        scheduler.runUntil(horizon);
+        double seconds = secondsSince(start);
+        std::cout << "scheduler alone: " << scheduler.resumes() << " resumes, "
+                  << seconds * 1e9 / scheduler.resumes() << " ns per resume\n";
+    }
+    return 0;
+}
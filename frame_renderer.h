@@ -0,0 +1,289 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "tetris_engine.h"
+
+// Offline rasterizer: draws TetrisEngine states into an in-memory RGB frame laid out
+// like the console screen (bordered board on the left, next piece and numbers on the right).
+//
+// Every console color gets a prebuilt CELL x CELL sprite and cells are blitted one
+// sprite row at a time with memcpy. The frame persists between calls and only board
+// rows, the preview and numbers that changed since the last frame are redrawn; the
+// pixel lines they touched are flagged so YuvFrame converts just those.
+const int CELL = 8;
+const int PANEL_CELLS = 7;
+const int FRAME_WIDTH = (GRID_WIDTH + PANEL_CELLS + 3) * CELL;
+const int FRAME_HEIGHT = (GRID_HEIGHT + 2) * CELL;
+const int FRAME_BYTES = FRAME_WIDTH * FRAME_HEIGHT * 3;
+
+// The 16 Windows console colors that COLOR_* and SetConsoleTextAttribute() refer to
+const uint8_t CONSOLE_PALETTE[16][3] = {
+    {0, 0, 0}, {0, 0, 128}, {0, 128, 0}, {0, 128, 128}, {128, 0, 0}, {128, 0, 128}, {128, 128, 0}, {192, 192, 192},
+    {128, 128, 128}, {0, 0, 255}, {0, 255, 0}, {0, 255, 255}, {255, 0, 0}, {255, 0, 255}, {255, 255, 0}, {255, 255, 255},
+};
+
+class FrameRenderer {
+public:
+    FrameRenderer() : frame(FRAME_BYTES) {
+        buildSprites();
+        clear();
+    }
+
+    // Forget what was drawn, so the next render() draws everything
+    void clear() {
+        std::memset(frame.data(), 0, frame.size());
+        std::memset(changed, 1, sizeof(changed));
+        cleared = true;
+        std::memset(shown, 0xff, sizeof(shown));
+        shownNext = -1;
+        for (int i = 0; i < 3; i++) shownNumbers[i] = -1;
+
+        // Border, like drawBorder()'s asterisks
+        for (int y = 0; y < GRID_HEIGHT + 2; y++) {
+            blitCell(BORDER_SPRITE, 0, y);
+            blitCell(BORDER_SPRITE, GRID_WIDTH + 1, y);
+        }
+        for (int x = 1; x <= GRID_WIDTH; x++) {
+            blitCell(BORDER_SPRITE, x, 0);
+            blitCell(BORDER_SPRITE, x, GRID_HEIGHT + 1);
+        }
+    }
+
+    template <typename Engine>
+    const uint8_t* render(const Engine& game) {
+        if (!cleared) std::memset(changed, 0, sizeof(changed));
+        cleared = false;
+
+        // Grid colors with the falling piece drawn in, as drawBorder() then drawCurrentPiece() would
+        uint8_t cells[GRID_HEIGHT][GRID_WIDTH];
+        std::memcpy(cells, game.grid, sizeof(cells));
+        if (game.gameState == GameState::PLAYING) {
+            for (const auto& pos : game.currentPiece.getGlobalPositions(game.pieceX, game.pieceY)) {
+                if (pos.y >= 0 && pos.y < GRID_HEIGHT && pos.x >= 0 && pos.x < GRID_WIDTH) {
+                    cells[pos.y][pos.x] = static_cast<uint8_t>(game.currentPiece.color);
+                }
+            }
+        }
+
+        for (int y = 0; y < GRID_HEIGHT; y++) {
+            if (std::memcmp(cells[y], shown[y], GRID_WIDTH) == 0) continue;
+            std::memcpy(shown[y], cells[y], GRID_WIDTH);
+            drawBoardRow(y, cells[y]);
+        }
+
+        int next = static_cast<int>(game.nextPiece.type);
+        if (next != shownNext) {
+            shownNext = next;
+            drawNextPiece(game.nextPiece);
+        }
+
+        const int numbers[3] = {game.score, game.linesCleared, game.level};
+        for (int i = 0; i < 3; i++) {
+            if (numbers[i] != shownNumbers[i]) {
+                shownNumbers[i] = numbers[i];
+                drawNumber(numbers[i], PANEL_TOP + 6 + 2 * i);
+            }
+        }
+        return frame.data();
+    }
+
+    const uint8_t* pixels() const {
+        return frame.data();
+    }
+
+    // Whether pixel line y differs from the frame before the latest render()
+    bool lineChanged(int y) const {
+        return changed[y];
+    }
+
+private:
+    static const int EMPTY_SPRITE = 16;
+    static const int BORDER_SPRITE = 17;
+    static const int SPRITES = 18;
+    static const int PANEL_LEFT = GRID_WIDTH + 3; // In cells
+    static const int PANEL_TOP = 1;
+
+    std::vector<uint8_t> frame;
+    bool changed[FRAME_HEIGHT];
+    bool cleared = true; // Everything stays flagged until the first render() after clear()
+    uint8_t sprites[SPRITES][CELL][CELL * 3];
+    uint8_t shown[GRID_HEIGHT][GRID_WIDTH];
+    int shownNext;
+    int shownNumbers[3];
+
+    // Solid cell with a lighter top-left edge and darker bottom-right edge, like a block
+    void buildSprites() {
+        for (int s = 0; s < SPRITES; s++) {
+            const uint8_t* base = s < 16 ? CONSOLE_PALETTE[s] : CONSOLE_PALETTE[s == EMPTY_SPRITE ? 0 : 7];
+            for (int y = 0; y < CELL; y++) {
+                for (int x = 0; x < CELL; x++) {
+                    int shade = 0;
+                    if (s == EMPTY_SPRITE) {
+                        shade = (x == CELL - 1 || y == CELL - 1) ? 24 : 0; // Faint grid lines
+                    } else if (x == 0 || y == 0) {
+                        shade = 48;
+                    } else if (x == CELL - 1 || y == CELL - 1) {
+                        shade = -64;
+                    }
+                    for (int c = 0; c < 3; c++) {
+                        int value = base[c] + shade;
+                        sprites[s][y][x * 3 + c] = static_cast<uint8_t>(value < 0 ? 0 : value > 255 ? 255 : value);
+                    }
+                }
+            }
+        }
+    }
+
+    uint8_t* pixel(int x, int y) {
+        changed[y] = true;
+        return frame.data() + (static_cast<size_t>(y) * FRAME_WIDTH + x) * 3;
+    }
+
+    void blitCell(int sprite, int cellX, int cellY) {
+        for (int line = 0; line < CELL; line++) {
+            std::memcpy(pixel(cellX * CELL, cellY * CELL + line), sprites[sprite][line], CELL * 3);
+        }
+    }
+
+    // One board row, sprite line by sprite line across all ten cells
+    void drawBoardRow(int y, const uint8_t* colors) {
+        for (int line = 0; line < CELL; line++) {
+            uint8_t* out = pixel(CELL, (y + 1) * CELL + line);
+            for (int x = 0; x < GRID_WIDTH; x++) {
+                int sprite = colors[x] ? colors[x] & 15 : EMPTY_SPRITE;
+                std::memcpy(out + x * CELL * 3, sprites[sprite][line], CELL * 3);
+            }
+        }
+    }
+
+    void drawNextPiece(const Tetromino& piece) {
+        for (int y = 0; y < 4; y++) {
+            for (int x = 0; x < 4; x++) {
+                blitCell(EMPTY_SPRITE, PANEL_LEFT + x, PANEL_TOP + 1 + y);
+            }
+        }
+        // Spawn shapes may sit anywhere in their rotation box (SRS uses negative
+        // offsets), so draw the blocks from their bounding box's corner
+        int minX, minY;
+        PieceShape shape = makePieceShape(piece.shape, minX, minY);
+        for (const auto& block : shape.blocks) {
+            if (block.x < 4 && block.y < 4) {
+                blitCell(piece.color & 15, PANEL_LEFT + block.x, PANEL_TOP + 1 + block.y);
+            }
+        }
+    }
+
+    // 3x5 digits drawn 2x, one digit per cell, right-aligned in the panel
+    void drawNumber(int value, int cellY) {
+        static const uint16_t DIGITS[10] = {
+            0x7b6f, 0x2492, 0x73e7, 0x73cf, 0x5bc9, 0x79cf, 0x79ef, 0x7249, 0x7bef, 0x7bcf,
+        };
+        for (int i = 0; i < PANEL_CELLS; i++) {
+            for (int line = 0; line < CELL * 2; line++) {
+                std::memset(pixel((PANEL_LEFT + i) * CELL, cellY * CELL + line), 0, CELL * 3);
+            }
+        }
+        if (value < 0) value = 0;
+        for (int i = PANEL_CELLS - 1; i >= 0; i--) {
+            uint16_t glyph = DIGITS[value % 10];
+            for (int row = 0; row < 5; row++) {
+                for (int col = 0; col < 3; col++) {
+                    if (!((glyph >> (14 - row * 3 - col)) & 1)) continue;
+                    for (int dy = 0; dy < 2; dy++) {
+                        uint8_t* out = pixel((PANEL_LEFT + i) * CELL + 1 + col * 2, cellY * CELL + 3 + row * 2 + dy);
+                        std::memset(out, 255, 2 * 3);
+                    }
+                }
+            }
+            value /= 10;
+            if (value == 0) break;
+        }
+    }
+};
+
+// One line of pixels in BT.601 limited range, the default Y4M interpretation
+inline void rgbToYuv(const uint8_t* rgb, uint8_t* yOut, uint8_t* uOut, uint8_t* vOut, int count) {
+    for (int i = 0; i < count; i++) {
+        int r = rgb[i * 3], g = rgb[i * 3 + 1], b = rgb[i * 3 + 2];
+        yOut[i] = static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+        uOut[i] = static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+        vOut[i] = static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+    }
+}
+
+// Planar YUV 4:4:4 copy of a renderer's frames (Y, U and V planes one after another),
+// kept up to date by converting only the lines the renderer redrew
+class YuvFrame {
+public:
+    YuvFrame() : planes(static_cast<size_t>(FRAME_WIDTH) * FRAME_HEIGHT * 3) {}
+
+    const uint8_t* update(const FrameRenderer& renderer) {
+        const size_t plane = static_cast<size_t>(FRAME_WIDTH) * FRAME_HEIGHT;
+        for (int y = 0; y < FRAME_HEIGHT; y++) {
+            if (primed && !renderer.lineChanged(y)) continue;
+            size_t offset = static_cast<size_t>(y) * FRAME_WIDTH;
+            rgbToYuv(renderer.pixels() + offset * 3, &planes[offset], &planes[plane + offset],
+                     &planes[2 * plane + offset], FRAME_WIDTH);
+        }
+        primed = true;
+        return planes.data();
+    }
+
+    size_t size() const {
+        return planes.size();
+    }
+
+private:
+    std::vector<uint8_t> planes;
+    bool primed = false; // The first update converts everything
+};
+
+// Raw video streams ffmpeg and most players read directly.
+// PPM: P6 images back to back ("ffmpeg -f image2pipe -c:v ppm -i game.ppm").
+// Y4M: YUV4MPEG2 with full-resolution chroma (C444) at the game's frame rate.
+class FrameWriter {
+public:
+    enum Format { PPM, Y4M };
+
+    FrameWriter() : file(nullptr), format(Y4M) {}
+    ~FrameWriter() {
+        close();
+    }
+
+    bool open(const char* path, Format streamFormat) {
+        close();
+        format = streamFormat;
+        file = std::fopen(path, "wb");
+        if (!file) return false;
+        if (format == Y4M) {
+            return std::fprintf(file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", FRAME_WIDTH, FRAME_HEIGHT, 1000 / FRAME_MS) > 0;
+        }
+        return true;
+    }
+
+    // Appends the renderer's latest frame; frames must all come from the same renderer
+    bool write(const FrameRenderer& renderer) {
+        // Each frame's header counts too: a frame without one corrupts the stream
+        if (format == PPM) {
+            return std::fprintf(file, "P6\n%d %d\n255\n", FRAME_WIDTH, FRAME_HEIGHT) > 0 &&
+                   std::fwrite(renderer.pixels(), FRAME_BYTES, 1, file) == 1;
+        }
+        const uint8_t* planes = yuv.update(renderer);
+        return std::fputs("FRAME\n", file) != EOF && std::fwrite(planes, yuv.size(), 1, file) == 1;
+    }
+
+    // False if buffered frames couldn't be flushed
+    bool close() {
+        bool ok = !file || std::fclose(file) == 0;
+        file = nullptr;
+        return ok;
+    }
+
+private:
+    FILE* file;
+    Format format;
+    YuvFrame yuv;
+};
@@ -7,178 +7,26 @@
 #include <string>
 #include <limits.h>
 #include <fstream>
+#include <cstring>
 
-// Constants
-const int GRID_WIDTH = 10;
-const int GRID_HEIGHT = 20;
-const int SCREEN_WIDTH = 80;
-const int SCREEN_HEIGHT = 30;
-
-// Colors for different tetromino pieces
-const int COLOR_O = 14; // Yellow
-const int COLOR_I = 11; // Light Cyan
-const int COLOR_S = 12; // Light Red
-const int COLOR_Z = 10; // Light Green
-const int COLOR_L = 6;  // Brown/Orange
-const int COLOR_J = 13; // Light Magenta
-const int COLOR_T = 5;  // Purple
-
-// Game state
-enum class GameState {
-    PLAYING,
-    GAME_OVER,
-    RESTART
-};
+#include "tetris_engine.h"
+#include "adversarial_chooser.h"
+#include "autopilot.h"
+#include "pc_table.h"
+#include "nnue.h"
+#include "replay.h"
 
-// Tetromino shapes
-class Tetromino {
+// The game class: console input and drawing around a TetrisEngine
+class TetrisGame {
 public:
-    enum class Type {
-        O, I, S, Z, L, J, T
-    };
-
-    struct Position {
-        int x;
-        int y;
-    };
-
-    // Default constructor
-    Tetromino() : type(Type::O) {
-        initShape();
-    }
-
-    Tetromino(Type type) : type(type) {
-        initShape();
-    }
-
-    void initShape() {
-        switch (type) {
-        case Type::O:
-            // O shape (2x2 square)
-            shape = {
-                {0, 0}, {1, 0},
-                {0, 1}, {1, 1}
-            };
-            color = COLOR_O;
-            break;
-        case Type::I:
-            // I shape (vertical)
-            shape = {
-                {0, 0},
-                {0, 1},
-                {0, 2},
-                {0, 3}
-            };
-            color = COLOR_I;
-            break;
-        case Type::S:
-            // S shape
-            shape = {
-                {1, 0}, {2, 0},
-                {0, 1}, {1, 1}
-            };
-            color = COLOR_S;
-            break;
-        case Type::Z:
-            // Z shape
-            shape = {
-                {0, 0}, {1, 0},
-                {1, 1}, {2, 1}
-            };
-            color = COLOR_Z;
-            break;
-        case Type::L:
-            // L shape
-            shape = {
-                {0, 0},
-                {0, 1},
-                {0, 2}, {1, 2}
-            };
-            color = COLOR_L;
-            break;
-        case Type::J:
-            // J shape
-            shape = {
-                        {1, 0},
-                        {1, 1},
-                {0, 2}, {1, 2}
-            };
-            color = COLOR_J;
-            break;
-        case Type::T:
-            // T shape
-            shape = {
-                {0, 0}, {1, 0}, {2, 0},
-                        {1, 1}
-            };
-            color = COLOR_T;
-            break;
-        }
-    }
-
-    void rotate() {
-        // Skip rotation for O piece (square) since it looks the same
-        if (type == Type::O) return;
-
-        std::vector<Position> rotated;
-        
-        // Find center of rotation
-        int minX = INT_MAX, maxX = INT_MIN;
-        int minY = INT_MAX, maxY = INT_MIN;
-        
-        for (const auto& block : shape) {
-            minX = std::min(minX, block.x);
-            maxX = std::max(maxX, block.x);
-            minY = std::min(minY, block.y);
-            maxY = std::max(maxY, block.y);
-        }
-        
-        int centerX = (minX + maxX) / 2;
-        int centerY = (minY + maxY) / 2;
-        
-         // Special case for I piece (long bar) - it has an offset rotation center
-    if (type == Type::I) {
-        // For I piece, use a fixed rotation point 
-        // This gives better results than calculating center
-        for (const auto& block : shape) {
-            int x = block.x - 1;  // Use 1 as the center X
-            int y = block.y - 1;  // Use 1 as the center Y
-            
-            // (x, y) -> (y, -x) is a 90-degree clockwise rotation
-            rotated.push_back({1 + y, 1 - x});
-        }
-    } else {
-        // Rotate 90 degrees clockwise around the center
-        for (const auto& block : shape) {
-            int x = block.x - centerX;
-            int y = block.y - centerY;
-            
-            // (x, y) -> (y, -x) is a 90-degree clockwise rotation
-            rotated.push_back({centerX + y, centerY - x});
-        }
-    }
-    
-    // Update shape with rotated coordinates
-    shape = rotated;
-}
-
-    std::vector<Position> getGlobalPositions(int offsetX, int offsetY) const {
-        std::vector<Position> global;
-        for (const auto& block : shape) {
-            global.push_back({block.x + offsetX, block.y + offsetY});
+    // challenge: every next piece is the worst one for the stack (see adversarial_chooser.h)
+    explicit TetrisGame(bool challenge = false) : challengeMode(challenge) {
+        if (challengeMode) {
+            engine.chooser = &adversary;
+            // Time of every piece decision, for checking the search keeps to its budget
+            adversary.log = std::fopen("tetris_challenge.log", "w");
         }
-        return global;
-    }
 
-    Type type;
-    std::vector<Position> shape;
-    int color;
-};
-
-// The game class
-class TetrisGame {
-public:
-    TetrisGame() : currentPiece(getRandomPiece()), nextPiece(getRandomPiece()) {
         // Initialize console
         initConsole();
         resetGame();
@@ -187,43 +35,55 @@ public:
     ~TetrisGame() {
         // Restore console settings
         SetConsoleTextAttribute(consoleHandle, 7); // Reset to default color
+        if (adversary.log) std::fclose(adversary.log);
     }
 
     void run() {
         bool exitGame = false;
         
         while (!exitGame) {
-            gameState = GameState::PLAYING;
-            lastFallTime = GetTickCount();
+            engine.gameState = GameState::PLAYING;
             
-            while (gameState == GameState::PLAYING) {
+            while (engine.gameState == GameState::PLAYING) {
+                Input input = Input::NONE;
                 if (_kbhit()) {
                     int key = _getch();
                     if (key == 27) { // ESC key
-                        gameState = GameState::GAME_OVER;
+                        engine.gameState = GameState::GAME_OVER;
                         exitGame = true;
                         break;
                     }
-                    handleInput();
+                    input = handleInput();
                 }
 
-                // Check if it's time for the piece to fall
-                DWORD currentTime = GetTickCount();
-                if (currentTime - lastFallTime >= fallSpeed) {
-                    movePieceDown();
-                    lastFallTime = currentTime;
+                // The perfect-clear opening plays instead of the player while it lasts
+                Input openingMove;
+                if (openingInput(openingMove)) {
+                    input = openingMove;
                 }
 
+                // One frame of the game: input, then gravity if it's due
+                replay.inputs.push_back(input);
+                engine.tick(input);
+
                 render();
-                Sleep(50);
+                Sleep(FRAME_MS);
             }
 
-            if (gameState == GameState::GAME_OVER) {
+            if (engine.gameState == GameState::GAME_OVER) {
                 // Check if we have a new high score BEFORE saving it
-                 bool isNewHighScore = (score > highScore);
+                 bool isNewHighScore = (engine.score > highScore);
 
                 // Save high score
                 saveHighScore();
+
+                // Keep the last game so render_replay can turn it into video. Challenge
+                // pieces depend on how fast the search ran, so those games can't be
+                // replayed from their seed and inputs and aren't saved.
+                if (!challengeMode) {
+                    replay.finalScore = engine.score;
+                    replay.save("tetris_replay.bin");
+                }
                 
               // Game over screen with restart option - pass the highscore flag
               renderGameOver(isNewHighScore);
@@ -254,28 +114,35 @@ public:
     }
 
 private:
-    // Game grid (0 = empty, other values = filled with color)
-    std::vector<std::vector<int>> grid;
-    
-    // Current falling piece
-    Tetromino currentPiece;
-    int pieceX, pieceY;
-    
-    // Next piece to appear
-    Tetromino nextPiece;
-    
-    // Game state variables
-    int score;
-    int level;
-    int linesCleared;
+    // Grid, pieces, score and gravity
+    TetrisEngine engine;
     int highScore;
-    GameState gameState;
-    int fallSpeed;
-    DWORD lastFallTime;
+
+    // Seed and inputs of the current game
+    Replay replay;
+
+    // Challenge mode: pieces from the adversarial chooser instead of the random generator
+    bool challengeMode;
+    AdversarialChooser adversary;
     
     // Console handle
     HANDLE consoleHandle = GetStdHandle(STD_OUTPUT_HANDLE);
 
+    // Perfect-clear opening table, used when tetris_pc.bin is present
+    PerfectClearTable openingTable;
+    bool openingMode;
+    bool openingPlanned;
+    int openingSteps;
+    int openingPieces;
+    Placement openingPlacement;
+    Board openingBoard;
+
+    // Optional neural evaluator loaded from tetris_nnue.bin. Its accumulator follows the
+    // grid as the engine locks pieces and clears lines instead of being rebuilt every frame.
+    NnueNetwork network;
+    NnueTracker nnueTracker{network};
+    bool networkLoaded = false;
+
     void initConsole() {
         // Hide cursor
         CONSOLE_CURSOR_INFO cursorInfo;
@@ -288,37 +155,31 @@ private:
         
         // Load high score
         loadHighScore();
+
+        // The opening table is optional, the game plays normally without it
+        openingTable.open("tetris_pc.bin");
+        networkLoaded = network.load("tetris_nnue.bin");
+        if (networkLoaded) {
+            engine.listener = &nnueTracker;
+        }
     }
     void resetGame() {
-        // Clear the grid
-        grid = std::vector<std::vector<int>>(GRID_HEIGHT, std::vector<int>(GRID_WIDTH, 0));
-        
-        // Reset game variables
-        currentPiece = getRandomPiece();
-        nextPiece = getRandomPiece();
-        pieceX = GRID_WIDTH / 2 - 1;
-        pieceY = 0;
-        score = 0;
-        level = 1;
-        linesCleared = 0;
-        gameState = GameState::PLAYING;
-        fallSpeed = 1000; // Initial falling speed in milliseconds
-        lastFallTime = GetTickCount();
-        
-        // Initialize random number generator
-        std::srand(static_cast<unsigned int>(std::time(nullptr)));
+        // New game with a fresh seed
+        uint32_t seed = static_cast<uint32_t>(std::time(nullptr));
+        engine.reset(seed);
+        replay.start(seed);
+        adversary.stats = ChooserStats();
+        if (adversary.log) std::fprintf(adversary.log, "game %u\n", seed);
+
+        openingMode = openingTable.isOpen();
+        openingPlanned = false;
+        openingPieces = 0;
         
         // Clear screen
         system("cls");
     }
 
-    Tetromino getRandomPiece() {
-        // Create a random tetromino
-        int randPiece = std::rand() % 7;
-        return Tetromino(static_cast<Tetromino::Type>(randPiece));
-    }
-
-    void handleInput() {
+    Input handleInput() {
         int key = _getch();
         
         switch (key) {
@@ -327,207 +188,68 @@ private:
             key = _getch(); // Get the actual key code
             switch (key) {
             case 75: // Left arrow
-                movePieceLeft();
-                break;
+                return Input::LEFT;
             case 77: // Right arrow
-                movePieceRight();
-                break;
+                return Input::RIGHT;
             case 72: // Up arrow
-                rotatePiece();
-                break;
+                return Input::ROTATE;
             case 80: // Down arrow
-                movePieceDown(); // Soft drop
-                break;
+                return Input::SOFT_DROP; // Soft drop
             }
         
             break;
             case 72: // Additional check for Up arrow without prefix
-            rotatePiece();
-            break;
+            return Input::ROTATE;
         case 75: // Additional check for Left arrow without prefix
-            movePieceLeft();
-            break;
+            return Input::LEFT;
         case 77: // Additional check for Right arrow without prefix
-            movePieceRight();
-            break;
+            return Input::RIGHT;
         case 80: // Additional check for Down arrow without prefix
-            movePieceDown(); 
-            break;
+            return Input::SOFT_DROP;
         
         case 32: // Spacebar - Hard drop
-            hardDrop();
-            break;
+            return Input::HARD_DROP;
         case 27: // ESC key - Pause/Quit
             // Could implement pause menu here
-            gameState = GameState::GAME_OVER;
+            engine.gameState = GameState::GAME_OVER;
             break;
         }
+        return Input::NONE;
     }
 
-    void movePieceLeft() {
-        pieceX--;
-        if (collision()) {
-            pieceX++; // Move back if collision
-        }
-    }
-
-    void movePieceRight() {
-        pieceX++;
-        if (collision()) {
-            pieceX--; // Move back if collision
-        }
-    }
-
-    void rotatePiece() {
-        // Save the original shape in case we need to revert
-        auto originalShape = currentPiece.shape;
-        
-        // Try to rotate
-        currentPiece.rotate();
-        
-        // Check if the rotated piece collides
-        if (collision()) {
-            // Wall kick attempts - try to shift the piece to make the rotation work
-            const int kicks[4] = {1, -1, 2, -2}; // Right, left, 2 right, 2 left
-            bool kickSucceeded = false;
-            
-            for (int kick : kicks) {
-                pieceX += kick;
-                if (!collision()) {
-                    kickSucceeded = true;
-                    break;
-                }
-                pieceX -= kick; // Revert the kick
+    // Perfect-clear autopilot: turns the opening table's placement for the current piece
+    // into the inputs a player would press (rotate, slide, hard drop), one per frame.
+    // Opening mode ends at the first perfect clear or as soon as the table has no answer.
+    bool openingInput(Input& input) {
+        if (!openingMode) return false;
+
+        Board board = Board::fromGrid(engine.grid);
+        if (!openingPlanned) {
+            if (openingPieces > 0 && board.empty()) {
+                openingMode = false; // Perfect clear done, the player takes over
+                return false;
             }
-            
-            // If all kicks failed, revert the rotation
-            if (!kickSucceeded) {
-                currentPiece.shape = originalShape;
+            if (!openingTable.lookup(board, engine.currentPiece.type, engine.nextPiece.type, openingPlacement)) {
+                openingMode = false; // Off the table, the player takes over
+                return false;
             }
+            openingPlanned = true;
+            openingBoard = board;
+            openingSteps = 0;
         }
-    }
 
-    void movePieceDown() {
-        pieceY++;
-        if (collision()) {
-            pieceY--; // Move back up if collision
-            lockPiece(); // Lock the piece in place
-            clearLines(); // Check and clear any full lines
-            spawnNewPiece(); // Spawn a new piece
+        // Give up if a rotation or slide got blocked, or gravity locked the piece first
+        if (!(board == openingBoard) || ++openingSteps > PILOT_MAX_STEPS) {
+            openingMode = false;
+            return false;
         }
-    }
 
-    void hardDrop() {
-        // Keep moving down until collision
-        while (!collision()) {
-            pieceY++;
-        }
-        pieceY--; // Move back up from the collision position
-        lockPiece(); // Lock the piece in place
-        clearLines(); // Check and clear any full lines
-        spawnNewPiece(); // Spawn a new piece
-    }
-
-    bool collision() {
-        for (const auto& pos : currentPiece.getGlobalPositions(pieceX, pieceY)) {
-            // Check boundaries
-            if (pos.x < 0 || pos.x >= GRID_WIDTH || pos.y < 0 || pos.y >= GRID_HEIGHT) {
-                return true;
-            }
-            
-            // Check collision with locked pieces
-            // Only check for collision with blocks if the position is within the grid
-            if (pos.y >= 0 && pos.y < GRID_HEIGHT && pos.x >= 0 && pos.x < GRID_WIDTH) {
-                if (grid[pos.y][pos.x] != 0) {
-                return true;
-            }
-        }
-    }
-        return false;
-}
-
-    void lockPiece() {
-        for (const auto& pos : currentPiece.getGlobalPositions(pieceX, pieceY)) {
-            if (pos.y >= 0 && pos.y < GRID_HEIGHT && pos.x >= 0 && pos.x < GRID_WIDTH) {
-                grid[pos.y][pos.x] = currentPiece.color;
-            }
-        }
-    }
-
-    void clearLines() {
-        int linesCleared = 0;
-        
-        for (int y = GRID_HEIGHT - 1; y >= 0; --y) {
-            bool lineFilled = true;
-            
-            // Check if this line is completely filled
-            for (int x = 0; x < GRID_WIDTH; ++x) {
-                if (grid[y][x] == 0) {
-                    lineFilled = false;
-                    break;
-                }
-            }
-            
-            if (lineFilled) {
-                linesCleared++;
-                
-                // Move all lines above this one down
-                for (int moveY = y; moveY > 0; --moveY) {
-                    for (int x = 0; x < GRID_WIDTH; ++x) {
-                        grid[moveY][x] = grid[moveY - 1][x];
-                    }
-                }
-                
-                // Clear the top line
-                for (int x = 0; x < GRID_WIDTH; ++x) {
-                    grid[0][x] = 0;
-                }
-                
-                // Since we've moved all lines down, we need to check this y-index again
-                y++;
-            }
-        }
-        
-        // Update score and level
-        if (linesCleared > 0) {
-            updateScoreAndLevel(linesCleared);
-        }
-    }
-
-    void updateScoreAndLevel(int lines) {
-        // Scoring system: more points for clearing multiple lines at once
-        const int pointsForLines[4] = {40, 100, 300, 1200};
-        
-        if (lines > 0 && lines <= 4) {
-            // Add points based on the number of lines and current level
-            score += pointsForLines[lines - 1] * level;
-        }
-        
-        // Update total lines cleared
-        this->linesCleared += lines;
-        
-        // Every 5 lines, increase level
-        level = 1 + (this->linesCleared / 5);
-        
-        // Increase speed as level increases
-        fallSpeed = 1000 / level;
-    }
-
-    void spawnNewPiece() {
-        // Set the current piece to the next piece
-        currentPiece = nextPiece;
-        
-        // Generate a new next piece
-        nextPiece = getRandomPiece();
-        
-        // Reset position
-        pieceX = GRID_WIDTH / 2 - 1;
-        pieceY = 0;
-        
-        // Check for game over
-        if (collision()) {
-            gameState = GameState::GAME_OVER;
+        input = pilotInput(engine, openingPlacement);
+        if (input == Input::HARD_DROP) {
+            openingPlanned = false;
+            openingPieces++;
         }
+        return true;
     }
 
     void render() {
@@ -568,7 +290,7 @@ private:
             
             for (int x = 0; x < GRID_WIDTH; x++) {
                 // Draw cell based on grid value
-                int cellValue = grid[y][x];
+                int cellValue = engine.grid[y][x];
                 if (cellValue != 0) {
                     SetConsoleTextAttribute(consoleHandle, cellValue);
                     std::cout <<char(219) << char(219); 
@@ -593,9 +315,9 @@ private:
 }
 
 void drawCurrentPiece() {
-    SetConsoleTextAttribute(consoleHandle, currentPiece.color);
+    SetConsoleTextAttribute(consoleHandle, engine.currentPiece.color);
     
-    for (const auto& pos : currentPiece.getGlobalPositions(pieceX, pieceY)) {
+    for (const auto& pos : engine.currentPiece.getGlobalPositions(engine.pieceX, engine.pieceY)) {
         if (pos.y >= 0 && pos.y < GRID_HEIGHT && pos.x >= 0 && pos.x < GRID_WIDTH) {
             setCursorPosition(pos.x * 2 + 1, pos.y + 1);
             std::cout <<char(219) << char(219); 
@@ -625,7 +347,7 @@ void drawNextPiece() {
       std::cout << "*";
       
       // Draw the next piece in the preview box
-      SetConsoleTextAttribute(consoleHandle, nextPiece.color);
+      SetConsoleTextAttribute(consoleHandle, engine.nextPiece.color);
       
       // Center the piece in the preview box
       int centerX = previewX + 6; // Adjusted from 5 to 6
@@ -635,12 +357,12 @@ void drawNextPiece() {
       int offsetX = 0;
       int offsetY = 0;
       
-      if (nextPiece.type == Tetromino::Type::I) {
+      if (engine.nextPiece.type == Tetromino::Type::I) {
           // Check if I piece is vertical (has height > width)
           int minX = INT_MAX, maxX = INT_MIN;
           int minY = INT_MAX, maxY = INT_MIN;
           
-          for (const auto& block : nextPiece.shape) {
+          for (const auto& block : engine.nextPiece.shape) {
               minX = std::min(minX, block.x);
               maxX = std::max(maxX, block.x);
               minY = std::min(minY, block.y);
@@ -657,7 +379,7 @@ void drawNextPiece() {
           }
       }
       
-      for (const auto& pos : nextPiece.shape) {
+      for (const auto& pos : engine.nextPiece.shape) {
           setCursorPosition(centerX + pos.x * 2 - 3 + offsetX * 2, centerY + pos.y - 1 + offsetY);
           std::cout << char(219) << char(219); 
       }
@@ -669,18 +391,29 @@ void drawInfo() {
     int infoX = GRID_WIDTH * 2 + 5;
     int infoY = 10;
     
+    if (challengeMode) {
+        SetConsoleTextAttribute(consoleHandle, 12);
+        setCursorPosition(infoX, infoY - 1);
+        std::cout << "CHALLENGE MODE";
+    }
+
     SetConsoleTextAttribute(consoleHandle, 11);
     setCursorPosition(infoX, infoY);
-    std::cout << "CURRENT SCORE: " << score;
+    std::cout << "CURRENT SCORE: " << engine.score;
 
     setCursorPosition(infoX, infoY + 1);
     std::cout << "HIGH SCORE: " << highScore;
     
     setCursorPosition(infoX, infoY + 2);
-    std::cout << "LEVEL: " << level;
+    std::cout << "LEVEL: " << engine.level;
     
     setCursorPosition(infoX, infoY + 3);
-    std::cout << "LINES: " << linesCleared;
+    std::cout << "LINES: " << engine.linesCleared;
+
+    if (networkLoaded) {
+        setCursorPosition(infoX, infoY + 4);
+        std::cout << "NET EVAL: " << nnueTracker.evaluate() << "     ";
+    }
     
     // Draw controls
     setCursorPosition(infoX, infoY + 5);
@@ -732,7 +465,7 @@ void renderGameOver(bool isNewHighScore) {
      // Final Score message
      setCursorPosition(messageX, messageY + 1);
      SetConsoleTextAttribute(consoleHandle, 13); // Reset color
-     std::cout << "Final Score: " << score;
+     std::cout << "Final Score: " << engine.score;
      
      // High Score message
      setCursorPosition(messageX, messageY + 2);
@@ -749,6 +482,17 @@ void renderGameOver(bool isNewHighScore) {
     std::cout << "Press 'R' to restart\n";
     SetConsoleTextAttribute(consoleHandle, 12);//red
     std::cout << "'ESC' / 'Q' to quit...";
+
+    // How long the challenge pieces took to pick this game
+    if (challengeMode && adversary.stats.decisions > 0) {
+        const ChooserStats& stats = adversary.stats;
+        setCursorPosition(messageX, messageY + 6);
+        SetConsoleTextAttribute(consoleHandle, 8);
+        std::cout << "Pieces chosen: " << stats.decisions << ", avg "
+                  << static_cast<int>(stats.totalSeconds / stats.decisions * 1e6) << " us, slowest "
+                  << static_cast<int>(stats.maxSeconds * 1e6) << " us, " << stats.fallbacks << " over budget";
+        if (adversary.log) std::fflush(adversary.log);
+    }
     }
 
    void setCursorPosition(int x, int y) {
@@ -758,8 +502,8 @@ void renderGameOver(bool isNewHighScore) {
 
    void saveHighScore() {
     // Update high score if current score is higher
-    if (score > highScore) {
-        highScore = score;
+    if (engine.score > highScore) {
+        highScore = engine.score;
         
         // Save to file
         std::ofstream file("tetris_highscore.txt");
@@ -782,7 +526,10 @@ void renderGameOver(bool isNewHighScore) {
       }
     }
 };
-int main() {
+int main(int argc, char** argv) {
+    // "game --challenge" hands out the worst piece for the stack instead of random ones
+    bool challenge = argc > 1 && std::strcmp(argv[1], "--challenge") == 0;
+
     // Set console handle for the title screen
     HANDLE consoleHandle = GetStdHandle(STD_OUTPUT_HANDLE);
 
@@ -936,6 +683,10 @@ int main() {
     std::cout << instructionPadding << "  ESC: ";
     SetConsoleTextAttribute(consoleHandle, 12);
     std::cout << "Quit game\n";
+    SetConsoleTextAttribute(consoleHandle, 11);
+    std::cout << instructionPadding << "  Start with --challenge: ";
+    SetConsoleTextAttribute(consoleHandle, 12);
+    std::cout << (challenge ? "Worst-case pieces (on)\n" : "Worst-case pieces\n");
     std::cout << "\n";
     SetConsoleTextAttribute(consoleHandle, 13);
     std::cout << instructionPadding <<"LEVEL WILL INCREASE AFTER EVERY 5 LINES.....";
@@ -946,7 +697,7 @@ int main() {
     
     _getch(); // Wait for a key press to start
     
-    TetrisGame game;
+    TetrisGame game(challenge);
     game.run();
     
     return 0;
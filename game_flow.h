@@ -0,0 +1,344 @@
+#pragma once
+
+// The game flow (spawn, fall, lock, clear, game over, restart wait) written as a C++20
+// coroutine instead of a loop that sleeps, so one thread can run thousands of games.
+// Each game suspends until its next gravity deadline or player input, and a
+// single-threaded FlowScheduler resumes whichever is due, in deadline order from a
+// timer heap. Needs -std=c++20; the rest of the game still builds as C++14, which is
+// why the console game keeps its own frame loop in TetrisGame::run(). The two agree on
+// what happens at game over: keys pressed before it are dropped, then R restarts and
+// ESC or Q quits.
+#if !defined(__cpp_impl_coroutine)
+#error "game_flow.h needs C++20 coroutines (-std=c++20)"
+#endif
+
+#include <algorithm>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <vector>
+#include "tetris_engine.h"
+
+// Keys outside the game itself, read like the console game reads R, ESC and Q
+enum class FlowCommand : uint8_t {
+    NONE,
+    RESTART,
+    QUIT
+};
+
+// Deadline for waits that only end with an input
+const uint64_t NO_DEADLINE = UINT64_MAX;
+
+// A coroutine the scheduler owns through this handle. It starts suspended, so nothing
+// runs until FlowScheduler::start(), and it's destroyed with the task.
+class FlowTask {
+public:
+    struct promise_type {
+        FlowTask get_return_object() {
+            return FlowTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    FlowTask() = default;
+    explicit FlowTask(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+    FlowTask(FlowTask&& other) noexcept : handle(other.handle) {
+        other.handle = nullptr;
+    }
+    FlowTask& operator=(FlowTask&& other) noexcept {
+        std::swap(handle, other.handle);
+        return *this;
+    }
+    ~FlowTask() {
+        if (handle) handle.destroy();
+    }
+
+    bool done() const {
+        return !handle || handle.done();
+    }
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+class InputChannel;
+
+// Single-threaded scheduler on a millisecond clock that only moves when told to.
+// Timers live in a binary heap ordered by (deadline, insertion order), so games due at
+// the same moment always run in the same order and every run is reproducible.
+class FlowScheduler {
+public:
+    explicit FlowScheduler(size_t expectedTimers = 0) : now(0), sequence(0), resumeCount(0) {
+        timers.reserve(expectedTimers);
+        ready.reserve(expectedTimers);
+    }
+
+    uint64_t time() const {
+        return now;
+    }
+
+    // Number of coroutine resumptions so far
+    uint64_t resumes() const {
+        return resumeCount;
+    }
+
+    void start(const FlowTask& task) {
+        ready.push_back(task.handle);
+    }
+
+    // Runs everything due up to `until` (inclusive), moving the clock along to each
+    // deadline. Returns when nothing is due before `until`; the clock is then `until`.
+    void runUntil(uint64_t until) {
+        for (;;) {
+            runReady();
+            if (timers.empty() || timers.front().deadline > until) break;
+
+            std::pop_heap(timers.begin(), timers.end(), Later());
+            Timer timer = timers.back();
+            timers.pop_back();
+            if (!claim(timer)) continue; // Woken some other way already
+            now = timer.deadline;
+            resume(timer.handle);
+        }
+        now = std::max(now, until);
+    }
+
+    // Earliest pending deadline, for a real-time driver to sleep until; UINT64_MAX when idle
+    uint64_t nextDeadline() const {
+        return timers.empty() ? UINT64_MAX : timers.front().deadline;
+    }
+
+    // co_await scheduler.sleepUntil(t) suspends until the clock reaches t
+    struct SleepAwaiter {
+        FlowScheduler& scheduler;
+        uint64_t deadline;
+
+        bool await_ready() const {
+            return deadline <= scheduler.now;
+        }
+        void await_suspend(std::coroutine_handle<> handle) {
+            scheduler.addTimer(deadline, handle, nullptr, 0);
+        }
+        void await_resume() const {}
+    };
+
+    SleepAwaiter sleepUntil(uint64_t deadline) {
+        return SleepAwaiter{*this, deadline};
+    }
+
+    SleepAwaiter sleepFor(uint64_t milliseconds) {
+        return SleepAwaiter{*this, now + milliseconds};
+    }
+
+private:
+    friend class InputChannel;
+
+    struct Timer {
+        uint64_t deadline;
+        uint64_t sequence;
+        std::coroutine_handle<> handle;
+        InputChannel* channel; // Set when the timer races an input, see InputChannel
+        uint32_t token;
+    };
+
+    // std heap functions build a max-heap, so "less" means "due later"
+    struct Later {
+        bool operator()(const Timer& a, const Timer& b) const {
+            return a.deadline != b.deadline ? a.deadline > b.deadline : a.sequence > b.sequence;
+        }
+    };
+
+    uint64_t now;
+    uint64_t sequence;
+    uint64_t resumeCount;
+    std::vector<Timer> timers;
+    std::vector<std::coroutine_handle<>> ready;
+    std::vector<std::coroutine_handle<>> running;
+
+    void addTimer(uint64_t deadline, std::coroutine_handle<> handle, InputChannel* channel, uint32_t token) {
+        timers.push_back(Timer{deadline, sequence++, handle, channel, token});
+        std::push_heap(timers.begin(), timers.end(), Later());
+    }
+
+    void wake(std::coroutine_handle<> handle) {
+        ready.push_back(handle);
+    }
+
+    void resume(std::coroutine_handle<> handle) {
+        resumeCount++;
+        handle.resume();
+    }
+
+    // Resumes woken coroutines in wake order, including any they wake in turn
+    void runReady() {
+        while (!ready.empty()) {
+            running.swap(ready);
+            for (std::coroutine_handle<> handle : running) {
+                resume(handle);
+            }
+            running.clear();
+        }
+    }
+
+    inline bool claim(const Timer& timer);
+};
+
+// A game's input events. The game co_awaits next(deadline), which resumes with the
+// first input or command to arrive or, if none comes by the deadline, with a timeout.
+// push() can come from the driver or from another coroutine on the same scheduler.
+class InputChannel {
+public:
+    struct Event {
+        bool timedOut;
+        Input input;
+        FlowCommand command;
+    };
+
+    explicit InputChannel(FlowScheduler& scheduler) : scheduler(scheduler), head(0), count(0), token(0) {}
+
+    // Queues an input and wakes the game if it's waiting. Inputs past the buffer are dropped,
+    // like keys typed faster than the game reads them.
+    void push(Input input) {
+        push(Event{false, input, FlowCommand::NONE});
+    }
+
+    void push(FlowCommand command) {
+        push(Event{false, Input::NONE, command});
+    }
+
+    // Drops everything queued and not yet read
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+    struct Awaiter {
+        InputChannel& channel;
+        uint64_t deadline;
+
+        bool await_ready() const {
+            return channel.count > 0 || deadline <= channel.scheduler.now;
+        }
+        void await_suspend(std::coroutine_handle<> handle) {
+            channel.waiter = handle;
+            ++channel.token;
+            if (deadline != NO_DEADLINE) {
+                channel.scheduler.addTimer(deadline, handle, &channel, channel.token);
+            }
+        }
+        Event await_resume() {
+            if (channel.count == 0) return Event{true, Input::NONE, FlowCommand::NONE};
+            Event event = channel.pending[channel.head];
+            channel.head = (channel.head + 1) % CAPACITY;
+            channel.count--;
+            return event;
+        }
+    };
+
+    Awaiter next(uint64_t deadline = NO_DEADLINE) {
+        return Awaiter{*this, deadline};
+    }
+
+private:
+    friend class FlowScheduler;
+
+    static const int CAPACITY = 8;
+
+    FlowScheduler& scheduler;
+    Event pending[CAPACITY];
+    int head;
+    int count;
+    uint32_t token; // Changes whenever a wait ends, so its timer knows to do nothing
+    std::coroutine_handle<> waiter;
+
+    void push(const Event& event) {
+        if (count == CAPACITY) return;
+        pending[(head + count++) % CAPACITY] = event;
+        if (waiter) {
+            token++; // Its deadline timer is stale now
+            scheduler.wake(waiter);
+            waiter = nullptr;
+        }
+    }
+};
+
+// A timer that raced an input only fires if the same wait is still on
+inline bool FlowScheduler::claim(const Timer& timer) {
+    if (!timer.channel) return true;
+    if (timer.channel->token != timer.token || !timer.channel->waiter) return false;
+    timer.channel->token++;
+    timer.channel->waiter = nullptr;
+    return true;
+}
+
+// Counters a game flow keeps for whoever drives it
+struct FlowStats {
+    uint64_t inputs = 0;
+    uint64_t gravitySteps = 0;
+    uint64_t games = 0;
+    bool quit = false; // The player quit; the flow has returned
+};
+
+// One game from spawn to game over and back until the player quits. Gravity is a
+// deadline fallSpeed after the last fall; anything the player does before then is
+// handled as it arrives. Like TetrisGame::run(), QUIT ends the flow at any time; a
+// finished game drops keys pressed while it was still running, ignores everything but
+// RESTART and QUIT, and restarts seeded from its own generator like VecEnv. The
+// engine's frame timer (fallTimer) isn't used here.
+template <typename Engine>
+FlowTask playGame(FlowScheduler& scheduler, Engine& engine, InputChannel& inputs, uint32_t seed, FlowStats& stats) {
+    engine.reset(seed);
+    for (;;) {
+        uint64_t lastFall = scheduler.time();
+        while (engine.gameState == GameState::PLAYING) {
+            InputChannel::Event event = co_await inputs.next(lastFall + engine.fallSpeed);
+            if (event.command == FlowCommand::QUIT) {
+                stats.quit = true;
+                co_return;
+            }
+            if (event.timedOut) {
+                // Falls, or locks, clears lines and spawns the next piece
+                lastFall += engine.fallSpeed;
+                engine.movePieceDown();
+                stats.gravitySteps++;
+                continue;
+            }
+
+            if (event.command != FlowCommand::NONE) continue; // R does nothing mid-game
+            stats.inputs++;
+            switch (event.input) {
+            case Input::LEFT:
+                engine.movePieceLeft();
+                break;
+            case Input::RIGHT:
+                engine.movePieceRight();
+                break;
+            case Input::ROTATE:
+                engine.rotatePiece();
+                break;
+            case Input::SOFT_DROP:
+                engine.softDrop();
+                break;
+            case Input::HARD_DROP:
+                engine.hardDrop();
+                break;
+            case Input::NONE:
+                break;
+            }
+        }
+
+        stats.games++;
+        inputs.clear();
+        for (;;) {
+            InputChannel::Event event = co_await inputs.next();
+            if (event.command == FlowCommand::QUIT) {
+                stats.quit = true;
+                co_return;
+            }
+            if (event.command == FlowCommand::RESTART) break;
+        }
+        engine.reset(engine.random.next());
+    }
+}
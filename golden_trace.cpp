@@ -0,0 +1,157 @@
+// Differential check of TetrisEngine against ReferenceEngine (the engine before any
+// optimizations). Both play the same seeded games from the same scripted inputs and
+// their state hashes are compared after every tick. The first tick where they differ
+// is reported with both boards, so a change that alters game outcomes can't slip by.
+// Build: g++ -O2 -std=c++17 -pthread golden_trace.cpp -o golden_trace
+// Usage: golden_trace [games=4000] [ticks=5000] [threads=all cores]
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "reference_engine.h"
+#include "tetris_env.h"
+
+// Inputs weighted toward moves and rotations so pieces travel and the stacks get messy
+static const Input SCRIPT_INPUTS[16] = {
+    Input::NONE, Input::NONE, Input::LEFT, Input::LEFT, Input::LEFT, Input::RIGHT, Input::RIGHT, Input::RIGHT,
+    Input::ROTATE, Input::ROTATE, Input::ROTATE, Input::SOFT_DROP, Input::SOFT_DROP, Input::HARD_DROP,
+    Input::HARD_DROP, Input::NONE,
+};
+
+// Everything one game's script does in a tick, generated the same way for both engines
+struct ScriptStep {
+    Input input;
+    int garbage; // Rows pushed in after the tick, 0 for none
+    int hole;
+};
+
+struct Script {
+    PieceRandom random;
+
+    explicit Script(uint32_t seed) {
+        random.seed(seed * 2654435761u ^ 0x5bd1e995u);
+    }
+
+    ScriptStep next() {
+        uint32_t r = random.next();
+        ScriptStep step = {SCRIPT_INPUTS[r & 15], 0, 0};
+        // Now and then some garbage, so addGarbage() is covered too
+        if ((r >> 4) % 512 == 0) {
+            step.garbage = 1 + (r >> 13) % 3;
+            step.hole = (r >> 16) % GRID_WIDTH;
+        }
+        return step;
+    }
+};
+
+template <typename Engine>
+static void play(Engine& engine, const ScriptStep& step) {
+    // A finished game restarts from its own generator, like VecEnv
+    if (engine.gameState != GameState::PLAYING) {
+        engine.reset(engine.random.next());
+    }
+    engine.tick(step.input);
+    if (step.garbage > 0 && engine.gameState == GameState::PLAYING) {
+        engine.addGarbage(step.garbage, step.hole);
+    }
+}
+
+// Tick of the first hash mismatch in one game, or -1 when the whole game matched
+static int firstDivergence(uint32_t seed, int ticks) {
+    ReferenceEngine reference(seed);
+    TetrisEngine candidate(seed);
+    Script script(seed);
+    if (hashState(reference) != hashState(candidate)) return 0;
+    for (int tick = 1; tick <= ticks; tick++) {
+        ScriptStep step = script.next();
+        play(reference, step);
+        play(candidate, step);
+        if (hashState(reference) != hashState(candidate)) return tick;
+    }
+    return -1;
+}
+
+template <typename Engine>
+static void dumpState(const char* name, const Engine& engine) {
+    std::cout << name << ": hash " << std::hex << hashState(engine) << std::dec
+              << ", piece " << static_cast<int>(engine.currentPiece.type) << " at (" << engine.pieceX << ", "
+              << engine.pieceY << "), next " << static_cast<int>(engine.nextPiece.type)
+              << ", score " << engine.score << ", level " << engine.level << ", lines " << engine.linesCleared
+              << ", fall " << engine.fallTimer << "/" << engine.fallSpeed << " ms"
+              << (engine.gameState == GameState::PLAYING ? "" : ", game over") << "\n";
+}
+
+// Row y of the grid with the falling piece drawn in: # locked, @ falling, . empty
+template <typename Engine>
+static std::string boardRow(const Engine& engine, int y) {
+    std::string row(GRID_WIDTH, '.');
+    for (int x = 0; x < GRID_WIDTH; x++) {
+        if (engine.grid[y][x] != 0) row[x] = '#';
+    }
+    for (const auto& pos : engine.currentPiece.getGlobalPositions(engine.pieceX, engine.pieceY)) {
+        if (pos.y == y && pos.x >= 0 && pos.x < GRID_WIDTH) row[pos.x] = '@';
+    }
+    return row;
+}
+
+// Replays the game up to the divergent tick and prints both sides
+static void report(int game, uint32_t seed, int divergentTick) {
+    ReferenceEngine reference(seed);
+    TetrisEngine candidate(seed);
+    Script script(seed);
+    ScriptStep step = {Input::NONE, 0, 0};
+    for (int tick = 1; tick <= divergentTick; tick++) {
+        step = script.next();
+        play(reference, step);
+        play(candidate, step);
+    }
+
+    std::cout << "game " << game << " (seed " << seed << ") diverged at tick " << divergentTick;
+    if (divergentTick > 0) {
+        std::cout << " after input " << static_cast<int>(step.input);
+        if (step.garbage > 0) std::cout << " and " << step.garbage << " garbage rows (hole " << step.hole << ")";
+    }
+    std::cout << "\n";
+    dumpState("reference", reference);
+    dumpState("candidate", candidate);
+    std::cout << "reference    candidate\n";
+    for (int y = 0; y < GRID_HEIGHT; y++) {
+        std::string left = boardRow(reference, y);
+        std::string right = boardRow(candidate, y);
+        std::cout << left << "   " << right << (left != right ? "   <" : "") << "\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    int games = argc > 1 ? std::atoi(argv[1]) : 4000;
+    int ticks = argc > 2 ? std::atoi(argv[2]) : 5000;
+    int threads = argc > 3 ? std::atoi(argv[3]) : static_cast<int>(std::thread::hardware_concurrency());
+    if (threads < 1) threads = 1;
+
+    std::vector<int> divergence(games, -1);
+    ShardPool pool(threads);
+    auto job = [&](int game) {
+        divergence[game] = firstDivergence(game + 1, ticks);
+    };
+    auto start = std::chrono::steady_clock::now();
+    pool.run(games, job);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    int failed = 0;
+    int firstFailed = -1;
+    for (int game = 0; game < games; game++) {
+        if (divergence[game] < 0) continue;
+        failed++;
+        if (firstFailed < 0) firstFailed = game;
+    }
+    std::cout << games << " games x " << ticks << " ticks on " << threads << " threads in " << seconds << " s ("
+              << 2.0 * games * ticks / seconds / 1e6 << " M engine ticks/s)\n";
+    if (failed == 0) {
+        std::cout << "all games match the reference engine\n";
+        return 0;
+    }
+
+    std::cout << failed << " of " << games << " games diverged\n";
+    report(firstFailed, firstFailed + 1, divergence[firstFailed]);
+    return 1;
+}
@@ -0,0 +1,299 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include "board_eval.h"
+
+// Small quantized neural board evaluator (NNUE style).
+//
+// Input: one feature per grid cell. The first layer is kept as an int16 accumulator
+// that is updated incrementally as cells are set and rows shift, instead of being
+// recomputed from the whole grid. The rest of the network is tiny and int8:
+//   accumulator (int16, NNUE_HIDDEN) -> clamp 0..127 -> int8 layer (NNUE_HIDDEN2)
+//   -> clamp 0..127 -> int8 output neuron
+// Activations use 127 for 1.0 and int8 weights use NNUE_WEIGHT_SCALE for 1.0.
+const int NNUE_INPUTS = GRID_WIDTH * GRID_HEIGHT;
+const int NNUE_HIDDEN = 256;
+const int NNUE_HIDDEN2 = 32;
+const int NNUE_WEIGHT_SCALE = 64;
+const int NNUE_WEIGHT_SHIFT = 6; // log2(NNUE_WEIGHT_SCALE)
+const uint32_t NNUE_MAGIC = 0x554e4e54; // "TNNU"
+const uint32_t NNUE_VERSION = 1;
+
+struct NnueNetwork {
+    alignas(32) int16_t inputWeights[NNUE_INPUTS][NNUE_HIDDEN];
+    alignas(32) int16_t inputBias[NNUE_HIDDEN];
+    alignas(32) int8_t hiddenWeights[NNUE_HIDDEN2][NNUE_HIDDEN];
+    int32_t hiddenBias[NNUE_HIDDEN2];
+    int8_t outputWeights[NNUE_HIDDEN2];
+    int32_t outputBias;
+
+    // Weight file: magic, version, layer sizes, then every array above in order (little endian)
+    bool load(const char* path) {
+        FILE* file = std::fopen(path, "rb");
+        if (!file) return false;
+        uint32_t header[5];
+        bool ok = std::fread(header, sizeof(header), 1, file) == 1 &&
+                  header[0] == NNUE_MAGIC && header[1] == NNUE_VERSION &&
+                  header[2] == NNUE_INPUTS && header[3] == NNUE_HIDDEN && header[4] == NNUE_HIDDEN2 &&
+                  std::fread(inputWeights, sizeof(inputWeights), 1, file) == 1 &&
+                  std::fread(inputBias, sizeof(inputBias), 1, file) == 1 &&
+                  std::fread(hiddenWeights, sizeof(hiddenWeights), 1, file) == 1 &&
+                  std::fread(hiddenBias, sizeof(hiddenBias), 1, file) == 1 &&
+                  std::fread(outputWeights, sizeof(outputWeights), 1, file) == 1 &&
+                  std::fread(&outputBias, sizeof(outputBias), 1, file) == 1;
+        std::fclose(file);
+        return ok;
+    }
+
+    bool save(const char* path) const {
+        FILE* file = std::fopen(path, "wb");
+        if (!file) return false;
+        const uint32_t header[5] = {NNUE_MAGIC, NNUE_VERSION, NNUE_INPUTS, NNUE_HIDDEN, NNUE_HIDDEN2};
+        bool ok = std::fwrite(header, sizeof(header), 1, file) == 1 &&
+                  std::fwrite(inputWeights, sizeof(inputWeights), 1, file) == 1 &&
+                  std::fwrite(inputBias, sizeof(inputBias), 1, file) == 1 &&
+                  std::fwrite(hiddenWeights, sizeof(hiddenWeights), 1, file) == 1 &&
+                  std::fwrite(hiddenBias, sizeof(hiddenBias), 1, file) == 1 &&
+                  std::fwrite(outputWeights, sizeof(outputWeights), 1, file) == 1 &&
+                  std::fwrite(&outputBias, sizeof(outputBias), 1, file) == 1;
+        std::fclose(file);
+        return ok;
+    }
+
+    // Small random weights, for benchmarks and checking the SIMD path against the scalar one
+    void randomize(unsigned seed) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> small(-8, 8);
+        std::uniform_int_distribution<int> weight(-64, 64);
+        for (int i = 0; i < NNUE_INPUTS; i++) {
+            for (int h = 0; h < NNUE_HIDDEN; h++) {
+                inputWeights[i][h] = static_cast<int16_t>(small(rng));
+            }
+        }
+        for (int h = 0; h < NNUE_HIDDEN; h++) {
+            inputBias[h] = static_cast<int16_t>(small(rng) * 4);
+        }
+        for (int o = 0; o < NNUE_HIDDEN2; o++) {
+            for (int h = 0; h < NNUE_HIDDEN; h++) {
+                hiddenWeights[o][h] = static_cast<int8_t>(weight(rng));
+            }
+            hiddenBias[o] = weight(rng) * 64;
+            outputWeights[o] = static_cast<int8_t>(weight(rng));
+        }
+        outputBias = 0;
+    }
+
+    static int feature(int x, int y) {
+        return y * GRID_WIDTH + x;
+    }
+};
+
+// Row updates on the accumulator. __restrict tells the compiler the weights never
+// alias the accumulator, which is what lets it vectorize these loops.
+inline void nnueAddRow(int16_t* __restrict values, const int16_t* __restrict w) {
+    for (int h = 0; h < NNUE_HIDDEN; h++) {
+        values[h] = static_cast<int16_t>(values[h] + w[h]);
+    }
+}
+
+inline void nnueSubRow(int16_t* __restrict values, const int16_t* __restrict w) {
+    for (int h = 0; h < NNUE_HIDDEN; h++) {
+        values[h] = static_cast<int16_t>(values[h] - w[h]);
+    }
+}
+
+inline void nnueMoveRow(int16_t* __restrict values, const int16_t* __restrict from, const int16_t* __restrict to) {
+    for (int h = 0; h < NNUE_HIDDEN; h++) {
+        values[h] = static_cast<int16_t>(values[h] - from[h] + to[h]);
+    }
+}
+
+// First-layer sums for one board
+struct NnueAccumulator {
+    alignas(32) int16_t values[NNUE_HIDDEN];
+
+    void reset(const NnueNetwork& net) {
+        std::memcpy(values, net.inputBias, sizeof(values));
+    }
+
+    // Recomputes from scratch; the incremental updates below must always match this
+    void refresh(const NnueNetwork& net, const Board& board) {
+        reset(net);
+        for (int y = 0; y < GRID_HEIGHT; y++) {
+            for (int x = 0; x < GRID_WIDTH; x++) {
+                if (board.filled(x, y)) addCell(net, x, y);
+            }
+        }
+    }
+
+    void addCell(const NnueNetwork& net, int x, int y) {
+        nnueAddRow(values, net.inputWeights[NnueNetwork::feature(x, y)]);
+    }
+
+    void removeCell(const NnueNetwork& net, int x, int y) {
+        nnueSubRow(values, net.inputWeights[NnueNetwork::feature(x, y)]);
+    }
+
+    // Mirrors one step of clearLines(): full row `row` disappears and every row above
+    // it moves down one. `board` is the grid before the shift.
+    void clearRow(const NnueNetwork& net, const Board& board, int row) {
+        for (int x = 0; x < GRID_WIDTH; x++) {
+            removeCell(net, x, row);
+        }
+        for (int y = row - 1; y >= 0; --y) {
+            for (int x = 0; x < GRID_WIDTH; x++) {
+                if (!board.filled(x, y)) continue;
+                nnueMoveRow(values, net.inputWeights[NnueNetwork::feature(x, y)],
+                            net.inputWeights[NnueNetwork::feature(x, y + 1)]);
+            }
+        }
+    }
+};
+
+inline int8_t nnueClamp(int32_t value) {
+    return static_cast<int8_t>(value < 0 ? 0 : value > 127 ? 127 : value);
+}
+
+// Scalar reference for everything after the accumulator
+inline float nnueEvaluateScalar(const NnueNetwork& net, const NnueAccumulator& acc) {
+    int8_t hidden[NNUE_HIDDEN];
+    for (int h = 0; h < NNUE_HIDDEN; h++) {
+        hidden[h] = nnueClamp(acc.values[h]);
+    }
+    int32_t output = net.outputBias;
+    for (int o = 0; o < NNUE_HIDDEN2; o++) {
+        int32_t sum = net.hiddenBias[o];
+        for (int h = 0; h < NNUE_HIDDEN; h++) {
+            sum += hidden[h] * net.hiddenWeights[o][h];
+        }
+        output += nnueClamp(sum >> NNUE_WEIGHT_SHIFT) * net.outputWeights[o];
+    }
+    return static_cast<float>(output) / (127 * NNUE_WEIGHT_SCALE);
+}
+
+#ifdef TETRIS_X86
+// Same integer math as nnueEvaluateScalar(). Activations are 0..127 and weights are
+// int8, so the pairwise sums from maddubs (at most 2 * 127 * 128) never saturate.
+TETRIS_TARGET_AVX2 inline float nnueEvaluateAVX2(const NnueNetwork& net, const NnueAccumulator& acc) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i max = _mm256_set1_epi16(127);
+    const __m256i ones = _mm256_set1_epi16(1);
+
+    alignas(32) uint8_t hidden[NNUE_HIDDEN];
+    for (int h = 0; h < NNUE_HIDDEN; h += 32) {
+        __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(&acc.values[h]));
+        __m256i b = _mm256_load_si256(reinterpret_cast<const __m256i*>(&acc.values[h + 16]));
+        a = _mm256_min_epi16(_mm256_max_epi16(a, zero), max);
+        b = _mm256_min_epi16(_mm256_max_epi16(b, zero), max);
+        // packus works within 128-bit halves, the permute puts the bytes back in order
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xd8);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(&hidden[h]), packed);
+    }
+
+    int32_t output = net.outputBias;
+    for (int o = 0; o < NNUE_HIDDEN2; o++) {
+        __m256i sum = zero;
+        for (int h = 0; h < NNUE_HIDDEN; h += 32) {
+            __m256i in = _mm256_load_si256(reinterpret_cast<const __m256i*>(&hidden[h]));
+            __m256i w = _mm256_load_si256(reinterpret_cast<const __m256i*>(&net.hiddenWeights[o][h]));
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(in, w), ones));
+        }
+        __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4e));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xb1));
+        int32_t total = net.hiddenBias[o] + _mm_cvtsi128_si32(half);
+        output += nnueClamp(total >> NNUE_WEIGHT_SHIFT) * net.outputWeights[o];
+    }
+    return static_cast<float>(output) / (127 * NNUE_WEIGHT_SCALE);
+}
+#endif
+
+typedef float (*NnueEvaluateFn)(const NnueNetwork&, const NnueAccumulator&);
+
+inline NnueEvaluateFn selectNnueEvaluator() {
+#ifdef TETRIS_X86
+    if (cpuHasAVX2()) return nnueEvaluateAVX2;
+#endif
+    return nnueEvaluateScalar;
+}
+
+inline float nnueEvaluate(const NnueNetwork& net, const NnueAccumulator& acc) {
+    static const NnueEvaluateFn evaluate = selectNnueEvaluator();
+    return evaluate(net, acc);
+}
+
+// Accumulator for the board after a placement and its line clears, derived from the
+// accumulator of the board before it: four cell additions plus any row shifts
+inline void nnueApplyPlacement(const NnueNetwork& net, const Board& board, const Placement& placement,
+                               NnueAccumulator& acc, Board& result) {
+    const PieceShape& shape = pieceTable().shapes[placement.type][placement.rotation];
+    for (const auto& block : shape.blocks) {
+        acc.addCell(net, placement.x + block.x, placement.y + block.y);
+    }
+    result = applyPlacement(board, placement);
+    for (int y = 0; y < GRID_HEIGHT; y++) {
+        // Rows are cleared top to bottom so the rows below a cleared one haven't moved yet
+        if (result.rows[y] == FULL_ROW) {
+            acc.clearRow(net, result, y);
+            for (int moveY = y; moveY > 0; --moveY) {
+                result.rows[moveY] = result.rows[moveY - 1];
+            }
+            result.rows[0] = 0;
+        }
+    }
+}
+
+// Placement search scored by the network instead of the hand-weighted heuristic
+inline SearchResult findBestPlacementNnue(const NnueNetwork& net, const NnueAccumulator& acc,
+                                          const Board& board, Tetromino::Type type,
+                                          NnueEvaluateFn evaluate = nnueEvaluate) {
+    Placement placements[MAX_PLACEMENTS];
+    int count = enumeratePlacements(board, type, placements);
+
+    SearchResult result = {};
+    result.found = false;
+    for (int i = 0; i < count; i++) {
+        NnueAccumulator child = acc;
+        Board after;
+        nnueApplyPlacement(net, board, placements[i], child, after);
+        float score = evaluate(net, child);
+        if (!result.found || score > result.score) {
+            result.placement = placements[i];
+            result.score = score;
+            result.found = true;
+        }
+    }
+    return result;
+}
+
+// Keeps an accumulator in step with a TetrisEngine's grid
+class NnueTracker : public GridListener {
+public:
+    explicit NnueTracker(const NnueNetwork& net) : net(net) {
+        accumulator.reset(net);
+    }
+
+    void gridReset() override {
+        accumulator.reset(net);
+    }
+
+    void cellSet(int x, int y) override {
+        accumulator.addCell(net, x, y);
+    }
+
+    void rowCleared(const Board& before, int row) override {
+        accumulator.clearRow(net, before, row);
+    }
+
+    float evaluate() const {
+        return nnueEvaluate(net, accumulator);
+    }
+
+    NnueAccumulator accumulator;
+
+private:
+    const NnueNetwork& net;
+};
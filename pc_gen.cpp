@@ -0,0 +1,275 @@
+// Offline generator for the perfect-clear opening table read by pc_table.h.
+// Build: g++ -O2 -std=c++17 -pthread pc_gen.cpp -o pc_gen
+// Usage: pc_gen [output=tetris_pc.bin] [height=2] [threads]
+//
+// Height 2 (five-piece clears) takes under a minute on one core. Height 4 searches a
+// 40-bit board space and needs a machine with tens of GB of memory.
+//
+// 1. Breadth-first search from the empty grid over every hard-drop placement of every
+//    piece that keeps the stack inside the bottom `height` rows. Each level of the
+//    search is split across threads and the new boards are merged with sort + unique,
+//    so equivalent boards reached through different orders are only expanded once.
+// 2. Mark boards from which some piece sequence still reaches an empty grid.
+// 3. Value-iterate the chance of finishing the clear with uniformly random pieces, the
+//    way TetrisGame::getRandomPiece() deals them, and store the current piece's best
+//    placement for every solvable board and (current, next) queue.
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "pc_table.h"
+
+static int pcHeight = 2;
+
+// Successor boards (after line clears) that stay within the table's rows
+template <typename Visit>
+static void forEachSuccessor(uint64_t bits, Tetromino::Type type, Visit visit) {
+    Board board = decodePerfectClearBoard(bits, pcHeight);
+    Placement placements[MAX_PLACEMENTS];
+    int count = enumeratePlacements(board, type, placements);
+    for (int i = 0; i < count; i++) {
+        Board next = applyPlacement(board, placements[i]);
+        next.clearLines();
+        uint64_t nextBits;
+        if (encodePerfectClearBoard(next, pcHeight, nextBits)) {
+            visit(placements[i], nextBits);
+        }
+    }
+}
+
+// Runs work(begin, end) over [0, count) split evenly between threads
+template <typename Work>
+static void parallelFor(size_t count, int threads, Work work) {
+    std::vector<std::thread> pool;
+    size_t chunk = (count + threads - 1) / threads;
+    for (int t = 0; t < threads; t++) {
+        size_t begin = t * chunk;
+        size_t end = std::min(count, begin + chunk);
+        if (begin >= end) break;
+        pool.emplace_back(work, begin, end);
+    }
+    for (auto& thread : pool) {
+        thread.join();
+    }
+}
+
+static bool contains(const std::vector<uint64_t>& sorted, uint64_t value) {
+    return std::binary_search(sorted.begin(), sorted.end(), value);
+}
+
+static size_t indexOf(const std::vector<uint64_t>& sorted, uint64_t value) {
+    return std::lower_bound(sorted.begin(), sorted.end(), value) - sorted.begin();
+}
+
+static bool writeTable(const char* path, const std::vector<uint64_t>& entries) {
+    FILE* file = std::fopen(path, "wb");
+    if (!file) return false;
+    PerfectClearHeader header = {PC_TABLE_MAGIC, PC_TABLE_VERSION, static_cast<uint32_t>(pcHeight), 0, entries.size()};
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(entries.data(), sizeof(uint64_t), entries.size(), file) == entries.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+int main(int argc, char** argv) {
+    const char* output = argc > 1 ? argv[1] : "tetris_pc.bin";
+    pcHeight = argc > 2 ? std::atoi(argv[2]) : 2;
+    int threads = argc > 3 ? std::atoi(argv[3]) : static_cast<int>(std::thread::hardware_concurrency());
+    if (threads < 1) threads = 1;
+    if (pcHeight < 2 || pcHeight > PC_MAX_HEIGHT || pcHeight % 2 != 0) {
+        // 10 * height cells must be a whole number of 4-cell pieces
+        std::cerr << "height must be 2 or 4\n";
+        return 1;
+    }
+
+    // 1. Every board reachable from empty, deduplicated level by level
+    std::vector<uint64_t> reachable = {0};
+    std::vector<uint64_t> frontier = {0};
+    for (int level = 0; !frontier.empty(); level++) {
+        std::vector<std::vector<uint64_t>> found(threads);
+        size_t chunk = (frontier.size() + threads - 1) / threads;
+        parallelFor(frontier.size(), threads, [&](size_t begin, size_t end) {
+            std::vector<uint64_t>& out = found[begin / chunk];
+            for (size_t i = begin; i < end; i++) {
+                for (int t = 0; t < PIECE_TYPES; t++) {
+                    forEachSuccessor(frontier[i], static_cast<Tetromino::Type>(t), [&](const Placement&, uint64_t next) {
+                        if (next != 0) out.push_back(next);
+                    });
+                }
+            }
+        });
+
+        std::vector<uint64_t> next;
+        for (const auto& part : found) {
+            next.insert(next.end(), part.begin(), part.end());
+        }
+        std::sort(next.begin(), next.end());
+        next.erase(std::unique(next.begin(), next.end()), next.end());
+        next.erase(std::remove_if(next.begin(), next.end(), [&](uint64_t bits) { return contains(reachable, bits); }), next.end());
+
+        std::vector<uint64_t> merged;
+        merged.reserve(reachable.size() + next.size());
+        std::merge(reachable.begin(), reachable.end(), next.begin(), next.end(), std::back_inserter(merged));
+        reachable.swap(merged);
+        frontier.swap(next);
+        std::cout << "level " << level + 1 << ": " << frontier.size() << " new boards, " << reachable.size() << " total" << std::endl;
+    }
+
+    // 2. Solvable = some placement leads to empty or to another solvable board.
+    // Repeat until nothing changes, since line clears can link boards across levels.
+    std::vector<char> solvable(reachable.size(), 0);
+    solvable[0] = 1; // The empty grid is the goal itself
+    for (bool changed = true; changed;) {
+        changed = false;
+        std::vector<char> updated(solvable);
+        parallelFor(reachable.size(), threads, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                if (solvable[i]) continue;
+                for (int t = 0; t < PIECE_TYPES && !updated[i]; t++) {
+                    forEachSuccessor(reachable[i], static_cast<Tetromino::Type>(t), [&](const Placement&, uint64_t next) {
+                        if (solvable[indexOf(reachable, next)]) updated[i] = 1;
+                    });
+                }
+            }
+        });
+        for (size_t i = 0; i < reachable.size(); i++) {
+            if (updated[i] && !solvable[i]) changed = true;
+        }
+        solvable.swap(updated);
+    }
+
+    // Solvable successors of every solvable board per piece type, so the value
+    // iteration below doesn't have to repeat the placement search
+    struct Move {
+        Placement placement;
+        uint32_t next;
+    };
+    std::vector<std::vector<Move>> moves(reachable.size() * PIECE_TYPES);
+    parallelFor(reachable.size(), threads, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            if (!solvable[i]) continue;
+            for (int t = 0; t < PIECE_TYPES; t++) {
+                forEachSuccessor(reachable[i], static_cast<Tetromino::Type>(t), [&](const Placement& placement, uint64_t next) {
+                    size_t n = indexOf(reachable, next);
+                    if (solvable[n]) moves[i * PIECE_TYPES + t].push_back({placement, static_cast<uint32_t>(n)});
+                });
+            }
+        }
+    });
+
+    // 3. Chance of finishing the clear when pieces are uniformly random, by value iteration.
+    // win[(i * 7 + c) * 7 + n] is the chance from board i with queue (c, n) playing the
+    // best move; pending[i * 7 + n] averages that over the unseen piece after n.
+    const int iterations = 24;
+    std::vector<float> win(reachable.size() * PIECE_TYPES * PIECE_TYPES, 0.0f);
+    std::vector<float> pending(reachable.size() * PIECE_TYPES, 0.0f);
+    auto chance = [&](const Move& move, int n) {
+        return move.next == 0 ? 1.0f : pending[move.next * PIECE_TYPES + n];
+    };
+    for (int round = 0; round < iterations; round++) {
+        parallelFor(reachable.size(), threads, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                if (!solvable[i]) continue;
+                for (int c = 0; c < PIECE_TYPES; c++) {
+                    for (int n = 0; n < PIECE_TYPES; n++) {
+                        float best = 0.0f;
+                        for (const Move& move : moves[i * PIECE_TYPES + c]) {
+                            best = std::max(best, chance(move, n));
+                        }
+                        win[(i * PIECE_TYPES + c) * PIECE_TYPES + n] = best;
+                    }
+                }
+            }
+        });
+        parallelFor(reachable.size(), threads, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                for (int n = 0; n < PIECE_TYPES; n++) {
+                    float sum = 0.0f;
+                    for (int m = 0; m < PIECE_TYPES; m++) {
+                        sum += win[(i * PIECE_TYPES + n) * PIECE_TYPES + m];
+                    }
+                    pending[i * PIECE_TYPES + n] = sum / PIECE_TYPES;
+                }
+            }
+        });
+    }
+
+    // Best move for every solvable board and two-piece queue
+    std::vector<std::vector<uint64_t>> parts(threads);
+    size_t chunk = (reachable.size() + threads - 1) / threads;
+    parallelFor(reachable.size(), threads, [&](size_t begin, size_t end) {
+        std::vector<uint64_t>& out = parts[begin / chunk];
+        for (size_t i = begin; i < end; i++) {
+            if (!solvable[i]) continue;
+            for (int c = 0; c < PIECE_TYPES; c++) {
+                for (int n = 0; n < PIECE_TYPES; n++) {
+                    const Move* best = nullptr;
+                    for (const Move& move : moves[i * PIECE_TYPES + c]) {
+                        if (!best || chance(move, n) > chance(*best, n)) best = &move;
+                    }
+                    if (best && chance(*best, n) > 0.0f) {
+                        uint64_t key = perfectClearKey(reachable[i], static_cast<Tetromino::Type>(c), static_cast<Tetromino::Type>(n));
+                        out.push_back(packPerfectClearEntry(key, best->placement));
+                    }
+                }
+            }
+        }
+    });
+
+    std::vector<uint64_t> entries;
+    for (const auto& part : parts) {
+        entries.insert(entries.end(), part.begin(), part.end());
+    }
+    std::sort(entries.begin(), entries.end());
+
+    size_t solvableCount = std::count(solvable.begin(), solvable.end(), 1);
+    std::cout << solvableCount << " of " << reachable.size() << " boards can still perfect clear, "
+              << entries.size() << " table entries\n";
+    float opening = 0.0f;
+    for (int c = 0; c < PIECE_TYPES; c++) {
+        opening += pending[c];
+    }
+    std::cout << "chance of a perfect clear from an empty grid: " << opening / PIECE_TYPES << "\n";
+
+    if (!writeTable(output, entries)) {
+        std::cerr << "can't write " << output << "\n";
+        return 1;
+    }
+
+    // Read it back through the runtime path so a broken file never ships
+    PerfectClearTable table;
+    if (!table.open(output)) {
+        std::cerr << "written table failed to load\n";
+        return 1;
+    }
+    Placement placement;
+    if (!entries.empty() && !table.lookup(Board(), Tetromino::Type::I, Tetromino::Type::O, placement)) {
+        std::cerr << "written table has no opening move for an empty grid\n";
+        return 1;
+    }
+
+    // The same table with that opening move corrupted, first to an I rotation that
+    // doesn't exist, then to a column past the wall: lookup must refuse both
+    if (!entries.empty()) {
+        uint64_t key = perfectClearKey(0, Tetromino::Type::I, Tetromino::Type::O);
+        std::vector<uint64_t> corrupt(entries);
+        uint64_t& entry = corrupt[indexOf(corrupt, key << PC_VALUE_BITS)];
+        const Placement bad[2] = {{0, MAX_ROTATIONS - 1, 0, 0}, {0, 0, 15, 0}};
+        std::string corruptPath = std::string(output) + ".corrupt";
+        for (const Placement& move : bad) {
+            entry = packPerfectClearEntry(key, move);
+            PerfectClearTable check;
+            if (!writeTable(corruptPath.c_str(), corrupt) || !check.open(corruptPath.c_str()) ||
+                check.lookup(Board(), Tetromino::Type::I, Tetromino::Type::O, placement)) {
+                std::remove(corruptPath.c_str());
+                std::cerr << "a corrupted table entry wasn't rejected\n";
+                return 1;
+            }
+        }
+        std::remove(corruptPath.c_str());
+    }
+    std::cout << "wrote " << output << " (" << sizeof(PerfectClearHeader) + entries.size() * sizeof(uint64_t) << " bytes)\n";
+    return 0;
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include "board.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Perfect-clear opening table.
+//
+// The file is a small header followed by sorted 64-bit entries. Each entry packs the
+// lookup key (bottom PC rows of the board, current piece, next piece) in the high bits
+// and the placement to play in the low PC_VALUE_BITS, so a lookup is a binary search
+// straight over the mapped file with nothing to parse at startup.
+const uint32_t PC_TABLE_MAGIC = 0x54435054; // "TPCT"
+const uint32_t PC_TABLE_VERSION = 1;
+const int PC_MAX_HEIGHT = 4;
+const int PC_VALUE_BITS = 6; // 2 bits rotation, 4 bits column
+
+struct PerfectClearHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t height;
+    uint32_t reserved;
+    uint64_t entryCount;
+};
+
+// Bottom `height` rows of the board, bottom row in the lowest bits.
+// Returns false when something sits above those rows, i.e. the board is out of the table's range.
+inline bool encodePerfectClearBoard(const Board& board, int height, uint64_t& bits) {
+    for (int y = 0; y < GRID_HEIGHT - height; y++) {
+        if (board.rows[y] != 0) return false;
+    }
+    bits = 0;
+    for (int r = 0; r < height; r++) {
+        bits |= static_cast<uint64_t>(board.rows[GRID_HEIGHT - 1 - r]) << (GRID_WIDTH * r);
+    }
+    return true;
+}
+
+inline Board decodePerfectClearBoard(uint64_t bits, int height) {
+    Board board;
+    for (int r = 0; r < height; r++) {
+        board.rows[GRID_HEIGHT - 1 - r] = static_cast<uint16_t>((bits >> (GRID_WIDTH * r)) & FULL_ROW);
+    }
+    return board;
+}
+
+inline uint64_t perfectClearKey(uint64_t boardBits, Tetromino::Type current, Tetromino::Type next) {
+    return (boardBits << 6) | (static_cast<uint64_t>(current) << 3) | static_cast<uint64_t>(next);
+}
+
+inline uint64_t packPerfectClearEntry(uint64_t key, const Placement& placement) {
+    return (key << PC_VALUE_BITS) | (static_cast<uint64_t>(placement.rotation) << 4) | static_cast<uint64_t>(placement.x);
+}
+
+// Read-only view of a table file mapped into memory
+class PerfectClearTable {
+public:
+    PerfectClearTable() : data(nullptr), size(0), header(nullptr), entries(nullptr) {}
+
+    ~PerfectClearTable() {
+        close();
+    }
+
+    PerfectClearTable(const PerfectClearTable&) = delete;
+    PerfectClearTable& operator=(const PerfectClearTable&) = delete;
+
+    bool open(const char* path) {
+        close();
+        if (!mapFile(path)) return false;
+
+        // The count is checked against the file before multiplying, so a huge count can't
+        // wrap around to a size that matches
+        header = static_cast<const PerfectClearHeader*>(data);
+        if (size < sizeof(PerfectClearHeader) || header->magic != PC_TABLE_MAGIC ||
+            header->version != PC_TABLE_VERSION || header->height == 0 || header->height > PC_MAX_HEIGHT ||
+            header->entryCount > (size - sizeof(PerfectClearHeader)) / sizeof(uint64_t) ||
+            size != sizeof(PerfectClearHeader) + header->entryCount * sizeof(uint64_t)) {
+            close();
+            return false;
+        }
+        entries = reinterpret_cast<const uint64_t*>(header + 1);
+        return true;
+    }
+
+    bool isOpen() const {
+        return data != nullptr;
+    }
+
+    // Next placement for this board and queue, if the table knows one
+    bool lookup(const Board& board, Tetromino::Type current, Tetromino::Type next, Placement& placement) const {
+        if (!isOpen()) return false;
+
+        uint64_t boardBits;
+        if (!encodePerfectClearBoard(board, static_cast<int>(header->height), boardBits)) return false;
+        uint64_t key = perfectClearKey(boardBits, current, next);
+
+        uint64_t lo = 0, hi = header->entryCount;
+        while (lo < hi) {
+            uint64_t mid = lo + (hi - lo) / 2;
+            if ((entries[mid] >> PC_VALUE_BITS) < key) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo == header->entryCount || (entries[lo] >> PC_VALUE_BITS) != key) return false;
+
+        // The file is external input: a rotation the piece doesn't have or a column past
+        // the wall is a corrupt entry, not a move
+        uint64_t value = entries[lo] & ((1u << PC_VALUE_BITS) - 1);
+        const PieceTable& table = pieceTable();
+        int type = static_cast<int>(current);
+        int rotation = static_cast<int>(value >> 4);
+        int x = static_cast<int>(value & 0xf);
+        if (rotation >= table.rotations[type] || x + table.shapes[type][rotation].width > GRID_WIDTH) return false;
+        placement.type = static_cast<uint8_t>(type);
+        placement.rotation = static_cast<uint8_t>(rotation);
+        placement.x = static_cast<int8_t>(x);
+        placement.y = static_cast<int8_t>(dropRow(board, table.shapes[type][rotation], x));
+        return placement.y >= 0;
+    }
+
+    void close() {
+        if (!data) return;
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+#else
+        munmap(const_cast<void*>(data), size);
+#endif
+        data = nullptr;
+        size = 0;
+        header = nullptr;
+        entries = nullptr;
+    }
+
+private:
+    const void* data;
+    size_t size;
+    const PerfectClearHeader* header;
+    const uint64_t* entries;
+
+    bool mapFile(const char* path) {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+            CloseHandle(file);
+            return false;
+        }
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping) return false;
+        data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping); // The view keeps the mapping alive
+        if (!data) return false;
+        size = static_cast<size_t>(fileSize.QuadPart);
+#else
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+        void* mapped = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) return false;
+        data = mapped;
+        size = static_cast<size_t>(st.st_size);
+#endif
+        return true;
+    }
+};
@@ -0,0 +1,194 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include "tetris_engine.h"
+
+#ifdef __linux__
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware performance counters for the calling thread, through Linux perf_event_open.
+// The counters are opened as one group so a single read() returns all of them from the
+// same instant. Any counter the CPU, kernel or container refuses (perf_event_paranoid,
+// virtual machines without a PMU, other systems) is simply missing; wall time is always
+// measured, so callers still get timings when no counter opens at all.
+const int PERF_EVENTS = 4;
+const char* const PERF_EVENT_NAMES[PERF_EVENTS] = {"cycles", "instructions", "cache_misses", "branch_misses"};
+const char* const TICK_PHASE_NAMES[TICK_PHASES] = {"input", "gravity", "lock", "line_clear", "render"};
+
+struct PerfSample {
+    uint64_t values[PERF_EVENTS];
+    uint64_t nanoseconds;
+};
+
+class PerfCounters {
+public:
+    PerfCounters() : leader(-1), opened(0) {
+        std::memset(slot, -1, sizeof(slot));
+        std::strcpy(problem, "perf_event_open is Linux only");
+#ifdef __linux__
+        bool failed = false;
+        const uint64_t configs[PERF_EVENTS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                               PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        for (int e = 0; e < PERF_EVENTS; e++) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[e];
+            attr.disabled = leader < 0;
+            attr.exclude_kernel = 1; // Also what perf_event_paranoid 2 allows
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+            int fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0));
+            if (fd < 0) {
+                // The first refusal usually explains the rest (no PMU, paranoid setting)
+                if (!failed) std::snprintf(problem, sizeof(problem), "%s: %s", PERF_EVENT_NAMES[e], std::strerror(errno));
+                failed = true;
+                continue;
+            }
+            if (leader < 0) leader = fd;
+            fds[opened] = fd;
+            slot[e] = opened++;
+        }
+        if (leader >= 0) {
+            ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+        if (opened == PERF_EVENTS) problem[0] = 0;
+    }
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (int i = 0; i < opened; i++) {
+            close(fds[i]);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool has(int event) const {
+        return slot[event] >= 0;
+    }
+
+    bool any() const {
+        return opened > 0;
+    }
+
+    // Why the first missing counter couldn't be opened, empty when all are there
+    const char* error() const {
+        return problem;
+    }
+
+    // Running totals since construction; missing counters read 0
+    void sample(PerfSample& out) const {
+        std::memset(out.values, 0, sizeof(out.values));
+#ifdef __linux__
+        if (leader >= 0) {
+            uint64_t buffer[1 + PERF_EVENTS];
+            if (read(leader, buffer, sizeof(buffer)) > 0) {
+                for (int e = 0; e < PERF_EVENTS; e++) {
+                    if (slot[e] >= 0 && static_cast<uint64_t>(slot[e]) < buffer[0]) out.values[e] = buffer[1 + slot[e]];
+                }
+            }
+        }
+#endif
+        out.nanoseconds = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+private:
+    int leader;
+    int fds[PERF_EVENTS];
+    int slot[PERF_EVENTS]; // Position of each event in the group's read(), -1 if missing
+    int opened;
+    char problem[96];
+};
+
+struct PerfTotals {
+    uint64_t calls = 0;
+    uint64_t spans = 0; // Stretches between two counter reads added in
+    uint64_t values[PERF_EVENTS] = {};
+    uint64_t nanoseconds = 0;
+
+    void add(const PerfSample& from, const PerfSample& to) {
+        for (int e = 0; e < PERF_EVENTS; e++) {
+            values[e] += to.values[e] - from.values[e];
+        }
+        nanoseconds += to.nanoseconds - from.nanoseconds;
+        spans++;
+    }
+};
+
+// Per-phase totals for engines and renderers that report through TickProbe.
+// Counts are exclusive: a line clear inside a hard drop counts toward LINE_CLEAR only,
+// not toward INPUT. Every enter() and leave() is one read() of the counter group, which
+// itself costs a few hundred cycles and lands in whichever span it ends. A phase with a
+// nested one inside is split into more spans, so it pays for more reads; calibrate()
+// measures the cost of one span and reports subtract it once per span, not per call.
+class PhaseProfiler : public TickProbe {
+public:
+    explicit PhaseProfiler(const PerfCounters& perfCounters) : counters(perfCounters), depth(0) {}
+
+    void enter(TickPhase phase) override {
+        PerfSample now;
+        counters.sample(now);
+        if (depth > 0) phases[static_cast<int>(stack[depth - 1])].add(last, now);
+        stack[depth++] = phase;
+        phases[static_cast<int>(phase)].calls++;
+        last = now;
+    }
+
+    void leave() override {
+        PerfSample now;
+        counters.sample(now);
+        phases[static_cast<int>(stack[depth - 1])].add(last, now);
+        depth--;
+        last = now;
+    }
+
+    // Counts of an empty span (one enter()/leave() pair), averaged over `rounds`
+    PerfTotals calibrate(int rounds = 10000) {
+        PerfTotals saved = phases[0];
+        phases[0] = PerfTotals();
+        for (int i = 0; i < rounds; i++) {
+            enter(static_cast<TickPhase>(0));
+            leave();
+        }
+        PerfTotals overhead = phases[0];
+        for (int e = 0; e < PERF_EVENTS; e++) {
+            overhead.values[e] /= rounds;
+        }
+        overhead.nanoseconds /= rounds;
+        overhead.calls = 1;
+        overhead.spans = 1;
+        phases[0] = saved;
+        return overhead;
+    }
+
+    void clear() {
+        for (PerfTotals& phase : phases) {
+            phase = PerfTotals();
+        }
+    }
+
+    PerfTotals phases[TICK_PHASES];
+
+private:
+    static const int MAX_NESTING = 4;
+
+    const PerfCounters& counters;
+    TickPhase stack[MAX_NESTING];
+    int depth;
+    PerfSample last;
+};
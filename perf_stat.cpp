@@ -0,0 +1,206 @@
+// Hardware counters (cycles, instructions, cache and branch misses) for the engine's
+// tick phases and for whole headless games, so it's clear whether clearLines() or the
+// renderer is memory-bound or mispredicting rather than just slow.
+// Games are placement-search bot games, recorded first and then replayed, so the bot's
+// own search isn't measured. Runs with wall time only where counters aren't available.
+// Build: g++ -O2 -std=c++17 -pthread perf_stat.cpp -o perf_stat
+// Usage: perf_stat [games=20] [--json out.json | --json -]
+// Counters need perf_event_paranoid <= 2 (or CAP_PERFMON) and a CPU the kernel exposes a PMU for.
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "autopilot.h"
+#include "board_eval.h"
+#include "frame_renderer.h"
+#include "perf_counters.h"
+#include "replay.h"
+
+// A bot game played at full speed, one input per tick
+static Replay botReplay(uint32_t seed, int maxTicks) {
+    Replay replay;
+    replay.start(seed);
+    TetrisEngine engine(seed);
+    uint32_t planned = 0;
+    Placement target = {};
+    int steps = 0;
+    while (engine.gameState == GameState::PLAYING && static_cast<int>(replay.inputs.size()) < maxTicks) {
+        if (engine.pieces != planned) {
+            planned = engine.pieces;
+            steps = 0;
+            target = findBestPlacement(Board::fromGrid(engine.grid), engine.currentPiece.type).placement;
+        }
+        Input input = ++steps > PILOT_MAX_STEPS ? Input::HARD_DROP : pilotInput(engine, target);
+        replay.inputs.push_back(input);
+        engine.tick(input);
+    }
+    replay.finalScore = engine.score;
+    return replay;
+}
+
+// Per-call average of `total` with the profiler's cost taken off each of its spans,
+// never below zero
+static double perCall(uint64_t total, uint64_t calls, uint64_t spans, uint64_t overhead) {
+    if (calls == 0) return 0;
+    double value = (double(total) - double(spans) * double(overhead)) / calls;
+    return value > 0 ? value : 0;
+}
+
+struct Report {
+    const PerfCounters& counters;
+    const PerfTotals* phases;
+    PerfTotals overhead;
+    PerfTotals games; // calls = games played
+    uint64_t gameTicks;
+
+    void print(FILE* out) const {
+        if (counters.any()) {
+            std::fprintf(out, "%-11s %10s %9s %9s %7s %9s %9s\n", "phase", "calls", "ns/call", "cycles", "IPC",
+                         "cache-mis", "branch-mis");
+        } else {
+            std::fprintf(out, "hardware counters unavailable (%s), wall time only\n", counters.error());
+            std::fprintf(out, "%-11s %10s %9s\n", "phase", "calls", "ns/call");
+        }
+        for (int p = 0; p < TICK_PHASES; p++) {
+            const PerfTotals& phase = phases[p];
+            std::fprintf(out, "%-11s %10llu %9.1f", TICK_PHASE_NAMES[p], static_cast<unsigned long long>(phase.calls),
+                         perCall(phase.nanoseconds, phase.calls, phase.spans, overhead.nanoseconds));
+            if (counters.any()) printCounters(out, phase, overhead);
+            std::fprintf(out, "\n");
+        }
+        std::fprintf(out, "profiler cost per span: %llu ns", static_cast<unsigned long long>(overhead.nanoseconds));
+        if (counters.any()) std::fprintf(out, ", %llu cycles", static_cast<unsigned long long>(overhead.values[0]));
+        std::fprintf(out, " (subtracted above)\n");
+
+        PerfTotals none;
+        std::fprintf(out, "whole games, no probe: %llu games, %llu ticks, %.1f ns/tick",
+                     static_cast<unsigned long long>(games.calls), static_cast<unsigned long long>(gameTicks),
+                     perCall(games.nanoseconds, gameTicks, 0, 0));
+        if (counters.any()) {
+            std::fprintf(out, "\n%-11s %10s %9s", "per tick", "", "");
+            PerfTotals perTick = games;
+            perTick.calls = gameTicks;
+            printCounters(out, perTick, none);
+        }
+        std::fprintf(out, "\n");
+    }
+
+    void json(FILE* out) const {
+        std::fprintf(out, "{\n  \"counters\": %s,\n", counters.any() ? "true" : "false");
+        std::fprintf(out, "  \"error\": \"%s\",\n", counters.error());
+        std::fprintf(out, "  \"overhead_per_span\": ");
+        writeTotals(out, overhead);
+        std::fprintf(out, ",\n  \"phases\": {\n");
+        for (int p = 0; p < TICK_PHASES; p++) {
+            std::fprintf(out, "    \"%s\": ", TICK_PHASE_NAMES[p]);
+            writeTotals(out, phases[p]);
+            std::fprintf(out, p + 1 < TICK_PHASES ? ",\n" : "\n");
+        }
+        std::fprintf(out, "  },\n  \"games\": ");
+        writeTotals(out, games);
+        std::fprintf(out, ",\n  \"game_ticks\": %llu\n}\n", static_cast<unsigned long long>(gameTicks));
+    }
+
+private:
+    void printCounters(FILE* out, const PerfTotals& totals, const PerfTotals& cost) const {
+        double cycles = perCall(totals.values[0], totals.calls, totals.spans, cost.values[0]);
+        double instructions = perCall(totals.values[1], totals.calls, totals.spans, cost.values[1]);
+        std::fprintf(out, " %9.1f", cycles);
+        if (counters.has(0) && counters.has(1) && cycles > 0) {
+            std::fprintf(out, " %7.2f", instructions / cycles);
+        } else {
+            std::fprintf(out, " %7s", "-");
+        }
+        for (int e = 2; e < PERF_EVENTS; e++) {
+            if (counters.has(e)) {
+                std::fprintf(out, " %9.3f", perCall(totals.values[e], totals.calls, totals.spans, cost.values[e]));
+            } else {
+                std::fprintf(out, " %9s", "-");
+            }
+        }
+    }
+
+    // Raw totals, missing counters as null
+    void writeTotals(FILE* out, const PerfTotals& totals) const {
+        std::fprintf(out, "{\"calls\": %llu, \"spans\": %llu, \"nanoseconds\": %llu",
+                     static_cast<unsigned long long>(totals.calls), static_cast<unsigned long long>(totals.spans),
+                     static_cast<unsigned long long>(totals.nanoseconds));
+        for (int e = 0; e < PERF_EVENTS; e++) {
+            if (counters.has(e)) {
+                std::fprintf(out, ", \"%s\": %llu", PERF_EVENT_NAMES[e], static_cast<unsigned long long>(totals.values[e]));
+            } else {
+                std::fprintf(out, ", \"%s\": null", PERF_EVENT_NAMES[e]);
+            }
+        }
+        std::fprintf(out, "}");
+    }
+};
+
+int main(int argc, char** argv) {
+    int games = 20;
+    const char* jsonPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else {
+            games = std::atoi(argv[i]);
+        }
+    }
+    if (games < 1) {
+        std::fprintf(stderr, "usage: perf_stat [games] [--json out.json | --json -]\n");
+        return 1;
+    }
+
+    std::vector<Replay> replays(games);
+    for (int i = 0; i < games; i++) {
+        replays[i] = botReplay(300 + i, 50000);
+    }
+
+    PerfCounters counters;
+    PhaseProfiler profiler(counters);
+    Report report = {counters, profiler.phases, profiler.calibrate(), PerfTotals(), 0};
+
+    // Every phase of every tick, then drawing the result as the renderer would for a video
+    FrameRenderer renderer;
+    for (const Replay& replay : replays) {
+        TetrisEngine engine(replay.seed);
+        engine.probe = &profiler;
+        renderer.clear();
+        for (Input input : replay.inputs) {
+            engine.tick(input);
+            profiler.enter(TickPhase::RENDER);
+            renderer.render(engine);
+            profiler.leave();
+        }
+        if (engine.score != replay.finalScore) {
+            std::fprintf(stderr, "game %u didn't replay to its recorded score\n", replay.seed);
+            return 1;
+        }
+    }
+
+    // Whole games with no probe attached, for the engine's undisturbed cost per tick
+    for (const Replay& replay : replays) {
+        PerfSample before, after;
+        counters.sample(before);
+        TetrisEngine engine(replay.seed);
+        for (Input input : replay.inputs) {
+            engine.tick(input);
+        }
+        counters.sample(after);
+        report.games.add(before, after);
+        report.games.calls++;
+        report.gameTicks += replay.inputs.size();
+    }
+
+    if (jsonPath) {
+        FILE* out = std::strcmp(jsonPath, "-") == 0 ? stdout : std::fopen(jsonPath, "w");
+        if (!out) {
+            std::fprintf(stderr, "can't write %s\n", jsonPath);
+            return 1;
+        }
+        report.json(out);
+        if (out != stdout) std::fclose(out);
+    }
+    if (!jsonPath || std::strcmp(jsonPath, "-") != 0) report.print(stdout);
+    return 0;
+}
@@ -0,0 +1,322 @@
+#pragma once
+
+#include <cstdint>
+#include "tetris_engine.h"
+
+// The engine exactly as it was before the rules became policies (classic scoring,
+// leveling and rotation written out inline). Kept as the baseline that benchmarks and
+// differential tests compare TetrisEngine against; don't change its behaviour.
+class ReferenceEngine {
+public:
+    explicit ReferenceEngine(uint32_t seed = 1) {
+        reset(seed);
+    }
+
+    void reset(uint32_t seed) {
+        // Clear the grid
+        for (int y = 0; y < GRID_HEIGHT; y++) {
+            for (int x = 0; x < GRID_WIDTH; x++) {
+                grid[y][x] = 0;
+            }
+        }
+        if (listener) {
+            listener->gridReset();
+        }
+
+        // Reset game variables
+        random.seed(seed);
+        currentPiece = getRandomPiece();
+        nextPiece = getRandomPiece();
+        pieceX = GRID_WIDTH / 2 - 1;
+        pieceY = 0;
+        score = 0;
+        level = 1;
+        linesCleared = 0;
+        gameState = GameState::PLAYING;
+        fallSpeed = 1000; // Initial falling speed in milliseconds
+        fallTimer = 0;
+        ticks = 0;
+        pieces = 1;
+        linesJustCleared = 0;
+    }
+
+    // Advances one frame: the player's input first, then gravity if it's due
+    void tick(Input input) {
+        if (gameState != GameState::PLAYING) return;
+        ticks++;
+        linesJustCleared = 0;
+
+        switch (input) {
+        case Input::LEFT:
+            movePieceLeft();
+            break;
+        case Input::RIGHT:
+            movePieceRight();
+            break;
+        case Input::ROTATE:
+            rotatePiece();
+            break;
+        case Input::SOFT_DROP:
+            movePieceDown();
+            break;
+        case Input::HARD_DROP:
+            hardDrop();
+            break;
+        case Input::NONE:
+            break;
+        }
+
+        // Check if it's time for the piece to fall
+        fallTimer += FRAME_MS;
+        if (gameState == GameState::PLAYING && fallTimer >= fallSpeed) {
+            movePieceDown();
+            fallTimer = 0;
+        }
+    }
+
+    // Pushes the stack up by `lines` rows of garbage, each with one empty cell at holeColumn.
+    // Blocks pushed off the top end the game, the same as a blocked spawn.
+    void addGarbage(int lines, int holeColumn) {
+        for (int i = 0; i < lines; i++) {
+            for (int x = 0; x < GRID_WIDTH; ++x) {
+                if (grid[0][x] != 0) {
+                    gameState = GameState::GAME_OVER;
+                }
+            }
+            for (int y = 0; y < GRID_HEIGHT - 1; ++y) {
+                for (int x = 0; x < GRID_WIDTH; ++x) {
+                    grid[y][x] = grid[y + 1][x];
+                }
+            }
+            for (int x = 0; x < GRID_WIDTH; ++x) {
+                grid[GRID_HEIGHT - 1][x] = x == holeColumn ? 0 : COLOR_GARBAGE;
+            }
+        }
+
+        if (listener) {
+            // Every row moved, so a rebuild is as cheap as anything incremental
+            listener->gridReset();
+            for (int y = 0; y < GRID_HEIGHT; y++) {
+                for (int x = 0; x < GRID_WIDTH; x++) {
+                    if (grid[y][x] != 0) listener->cellSet(x, y);
+                }
+            }
+        }
+
+        // The falling piece rides up with the stack if it now overlaps it
+        while (collision() && pieceY > 0) {
+            pieceY--;
+        }
+        if (collision()) {
+            gameState = GameState::GAME_OVER;
+        }
+    }
+
+    bool gravityDue() const {
+        return fallTimer + FRAME_MS >= fallSpeed;
+    }
+
+    void movePieceLeft() {
+        pieceX--;
+        if (collision()) {
+            pieceX++; // Move back if collision
+        }
+    }
+
+    void movePieceRight() {
+        pieceX++;
+        if (collision()) {
+            pieceX--; // Move back if collision
+        }
+    }
+
+    void rotatePiece() {
+        // Save the original shape in case we need to revert
+        auto originalShape = currentPiece.shape;
+
+        // Try to rotate
+        currentPiece.rotate();
+
+        // Check if the rotated piece collides
+        if (collision()) {
+            // Wall kick attempts - try to shift the piece to make the rotation work
+            const int kicks[4] = {1, -1, 2, -2}; // Right, left, 2 right, 2 left
+            bool kickSucceeded = false;
+
+            for (int kick : kicks) {
+                pieceX += kick;
+                if (!collision()) {
+                    kickSucceeded = true;
+                    break;
+                }
+                pieceX -= kick; // Revert the kick
+            }
+
+            // If all kicks failed, revert the rotation
+            if (!kickSucceeded) {
+                currentPiece.shape = originalShape;
+            }
+        }
+    }
+
+    void movePieceDown() {
+        pieceY++;
+        if (collision()) {
+            pieceY--; // Move back up if collision
+            lockPiece(); // Lock the piece in place
+            clearLines(); // Check and clear any full lines
+            spawnNewPiece(); // Spawn a new piece
+        }
+    }
+
+    void hardDrop() {
+        // Keep moving down until collision
+        while (!collision()) {
+            pieceY++;
+        }
+        pieceY--; // Move back up from the collision position
+        lockPiece(); // Lock the piece in place
+        clearLines(); // Check and clear any full lines
+        spawnNewPiece(); // Spawn a new piece
+    }
+
+    bool collision() const {
+        for (const auto& pos : currentPiece.getGlobalPositions(pieceX, pieceY)) {
+            // Check boundaries
+            if (pos.x < 0 || pos.x >= GRID_WIDTH || pos.y < 0 || pos.y >= GRID_HEIGHT) {
+                return true;
+            }
+
+            // Check collision with locked pieces
+            if (grid[pos.y][pos.x] != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Game grid (0 = empty, other values = filled with color)
+    uint8_t grid[GRID_HEIGHT][GRID_WIDTH];
+
+    // Current falling piece
+    Tetromino currentPiece;
+    int pieceX, pieceY;
+
+    // Next piece to appear
+    Tetromino nextPiece;
+
+    // Game state variables
+    int score;
+    int level;
+    int linesCleared;
+    GameState gameState;
+    int fallSpeed;
+    int fallTimer; // Milliseconds since the piece last fell
+    uint32_t ticks;
+    uint32_t pieces; // Pieces spawned so far, changes whenever a new piece appears
+    int linesJustCleared; // Lines cleared during the latest tick
+    PieceRandom random;
+
+    // Optional observer of grid changes (for example the NNUE accumulator)
+    GridListener* listener = nullptr;
+
+private:
+    Tetromino getRandomPiece() {
+        // Create a random tetromino
+        int randPiece = random.next() % 7;
+        return Tetromino(static_cast<Tetromino::Type>(randPiece));
+    }
+
+    void lockPiece() {
+        for (const auto& pos : currentPiece.getGlobalPositions(pieceX, pieceY)) {
+            if (pos.y >= 0 && pos.y < GRID_HEIGHT && pos.x >= 0 && pos.x < GRID_WIDTH) {
+                if (listener && grid[pos.y][pos.x] == 0) {
+                    listener->cellSet(pos.x, pos.y);
+                }
+                grid[pos.y][pos.x] = static_cast<uint8_t>(currentPiece.color);
+            }
+        }
+    }
+
+    void clearLines() {
+        int linesCleared = 0;
+
+        for (int y = GRID_HEIGHT - 1; y >= 0; --y) {
+            bool lineFilled = true;
+
+            // Check if this line is completely filled
+            for (int x = 0; x < GRID_WIDTH; ++x) {
+                if (grid[y][x] == 0) {
+                    lineFilled = false;
+                    break;
+                }
+            }
+
+            if (lineFilled) {
+                linesCleared++;
+
+                if (listener) {
+                    listener->rowCleared(Board::fromGrid(grid), y);
+                }
+
+                // Move all lines above this one down
+                for (int moveY = y; moveY > 0; --moveY) {
+                    for (int x = 0; x < GRID_WIDTH; ++x) {
+                        grid[moveY][x] = grid[moveY - 1][x];
+                    }
+                }
+
+                // Clear the top line
+                for (int x = 0; x < GRID_WIDTH; ++x) {
+                    grid[0][x] = 0;
+                }
+
+                // Since we've moved all lines down, we need to check this y-index again
+                y++;
+            }
+        }
+
+        // Update score and level
+        if (linesCleared > 0) {
+            updateScoreAndLevel(linesCleared);
+        }
+        linesJustCleared += linesCleared;
+    }
+
+    void updateScoreAndLevel(int lines) {
+        // Scoring system: more points for clearing multiple lines at once
+        const int pointsForLines[4] = {40, 100, 300, 1200};
+
+        if (lines > 0 && lines <= 4) {
+            // Add points based on the number of lines and current level
+            score += pointsForLines[lines - 1] * level;
+        }
+
+        // Update total lines cleared
+        this->linesCleared += lines;
+
+        // Every 5 lines, increase level
+        level = 1 + (this->linesCleared / 5);
+
+        // Increase speed as level increases
+        fallSpeed = 1000 / level;
+    }
+
+    void spawnNewPiece() {
+        // Set the current piece to the next piece
+        currentPiece = nextPiece;
+
+        // Generate a new next piece
+        nextPiece = getRandomPiece();
+
+        // Reset position
+        pieceX = GRID_WIDTH / 2 - 1;
+        pieceY = 0;
+        pieces++;
+
+        // Check for game over
+        if (collision()) {
+            gameState = GameState::GAME_OVER;
+        }
+    }
+};
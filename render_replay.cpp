@@ -0,0 +1,184 @@
+// Turns recorded games (tetris_replay.bin from the game) into video, one frame per tick.
+// Each replay becomes <replay>.y4m, or <replay>.ppm with --ppm; many replays render in parallel.
+// Build: g++ -O2 -std=c++17 -pthread render_replay.cpp -o render_replay
+// Usage: render_replay [--ppm] [--threads N] replay.bin...
+//        render_replay --bench [games=64] [threads]   (bot games rendered in memory, no files)
+// Encode: ffmpeg -i tetris_replay.bin.y4m -vf scale=iw*4:ih*4:flags=neighbor game.mp4
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "autopilot.h"
+#include "board_eval.h"
+#include "frame_renderer.h"
+#include "replay.h"
+#include "tetris_env.h"
+
+typedef std::chrono::steady_clock Clock;
+
+// Replays one game, rendering every tick. Returns false when the replay doesn't reach
+// the score it was recorded with.
+template <typename Sink>
+static bool renderReplay(const Replay& replay, FrameRenderer& renderer, Sink& sink) {
+    TetrisEngine engine(replay.seed);
+    renderer.clear();
+    sink(renderer.render(engine));
+    for (Input input : replay.inputs) {
+        engine.tick(input);
+        sink(renderer.render(engine));
+    }
+    return engine.score == replay.finalScore;
+}
+
+// A placement-search bot game, recorded like the console game records the player
+static Replay botReplay(uint32_t seed, int maxTicks) {
+    Replay replay;
+    replay.start(seed);
+    TetrisEngine engine(seed);
+    PieceRandom noise;
+    noise.seed(seed);
+    uint32_t planned = 0;
+    Placement target = {};
+    int steps = 0;
+    while (engine.gameState == GameState::PLAYING && static_cast<int>(replay.inputs.size()) < maxTicks) {
+        if (engine.pieces != planned) {
+            planned = engine.pieces;
+            steps = 0;
+            target = findBestPlacement(Board::fromGrid(engine.grid), engine.currentPiece.type).placement;
+        }
+        // Play at a watchable pace: mostly idle frames between moves
+        Input input = Input::NONE;
+        if (noise.next() % 3 == 0) {
+            input = ++steps > PILOT_MAX_STEPS ? Input::HARD_DROP : pilotInput(engine, target);
+        }
+        replay.inputs.push_back(input);
+        engine.tick(input);
+    }
+    replay.finalScore = engine.score;
+    return replay;
+}
+
+static int defaultThreads() {
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+    return cores > 0 ? cores : 1;
+}
+
+static int bench(int games, int threads) {
+    std::vector<Replay> replays(games);
+    for (int i = 0; i < games; i++) {
+        replays[i] = botReplay(100 + i, 20000);
+    }
+
+    // Render and convert to Y4M planes in memory, so only rasterizing and conversion are timed
+    std::vector<long long> frames(games, 0);
+    std::vector<uint8_t> ok(games, 0);
+    std::vector<uint64_t> checksums(games, 0);
+    auto job = [&](int i) {
+        FrameRenderer renderer;
+        YuvFrame yuv;
+        auto sink = [&](const uint8_t*) {
+            const uint8_t* planes = yuv.update(renderer);
+            frames[i]++;
+            checksums[i] += planes[(frames[i] * 7919) % yuv.size()];
+        };
+        ok[i] = renderReplay(replays[i], renderer, sink);
+    };
+    ShardPool pool(threads);
+    auto start = Clock::now();
+    pool.run(games, job);
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    long long total = 0;
+    for (int i = 0; i < games; i++) {
+        total += frames[i];
+        if (!ok[i]) {
+            std::cerr << "bot game " << i << " didn't replay to its recorded score\n";
+            return 1;
+        }
+    }
+    std::cout << games << " games, " << total << " frames of " << FRAME_WIDTH << "x" << FRAME_HEIGHT << " on "
+              << threads << " threads: " << total / seconds << " frames/s (" << total / seconds / threads
+              << " per thread)\n";
+
+    // Every frame fully redrawn and converted, for comparison with the dirty-line path above
+    {
+        FrameRenderer renderer;
+        YuvFrame yuv;
+        long long count = 0;
+        uint64_t checksum = 0;
+        auto sink = [&](const uint8_t*) {
+            checksum += yuv.update(renderer)[count++ % yuv.size()];
+            renderer.clear();
+        };
+        auto fullStart = Clock::now();
+        renderReplay(replays[0], renderer, sink);
+        double fullSeconds = std::chrono::duration<double>(Clock::now() - fullStart).count();
+        std::cout << "full redraw every frame: " << count / fullSeconds << " frames/s on one thread\n";
+        checksums[0] += checksum;
+    }
+    std::cout << "checksum: " << checksums[0] << "\n";
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) {
+        int games = argc > 2 ? std::atoi(argv[2]) : 64;
+        int threads = argc > 3 ? std::atoi(argv[3]) : defaultThreads();
+        return bench(games, threads > 0 ? threads : 1);
+    }
+
+    FrameWriter::Format format = FrameWriter::Y4M;
+    int threads = defaultThreads();
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--ppm") == 0) {
+            format = FrameWriter::PPM;
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.empty()) {
+        std::cerr << "usage: render_replay [--ppm] [--threads N] replay.bin...\n"
+                  << "       render_replay --bench [games] [threads]\n";
+        return 1;
+    }
+
+    int count = static_cast<int>(paths.size());
+    std::vector<int> results(count, 0); // 0 ok, 1 bad replay, 2 score mismatch, 3 write failed
+    auto job = [&](int i) {
+        Replay replay;
+        FrameWriter writer;
+        std::string output = paths[i] + (format == FrameWriter::PPM ? ".ppm" : ".y4m");
+        if (!replay.load(paths[i].c_str()) || !writer.open(output.c_str(), format)) {
+            results[i] = 1;
+            return;
+        }
+        FrameRenderer renderer;
+        bool written = true; // Until the first failed write; later frames are skipped
+        auto sink = [&](const uint8_t*) {
+            if (written) written = writer.write(renderer);
+        };
+        results[i] = renderReplay(replay, renderer, sink) ? 0 : 2;
+        if (!writer.close() || !written) results[i] = 3;
+    };
+    ShardPool pool(threads > 0 ? threads : 1);
+    pool.run(count, job);
+
+    int failed = 0;
+    for (int i = 0; i < count; i++) {
+        if (results[i] == 1) {
+            std::cerr << paths[i] << ": can't read the replay or write the video\n";
+        } else if (results[i] == 2) {
+            std::cerr << paths[i] << ": replay doesn't reach its recorded score, the video shows what it does reach\n";
+        } else if (results[i] == 3) {
+            std::cerr << paths[i] << ": writing the video failed, it's incomplete\n";
+        }
+        failed += results[i] != 0;
+    }
+    std::cout << count - failed << " of " << count << " replays rendered\n";
+    return failed ? 1 : 0;
+}
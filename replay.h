@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "tetris_engine.h"
+
+// A recorded game is its seed plus one Input per tick; TetrisEngine replays it exactly.
+// The score the game ended with is stored too, so a replay that doesn't reproduce it
+// is caught before anyone reviews it.
+const uint32_t REPLAY_MAGIC = 0x4c505254; // "TRPL"
+const uint32_t REPLAY_VERSION = 1;
+
+struct Replay {
+    uint32_t seed = 0;
+    int32_t finalScore = 0;
+    std::vector<Input> inputs;
+
+    void start(uint32_t gameSeed) {
+        seed = gameSeed;
+        finalScore = 0;
+        inputs.clear();
+    }
+
+    bool load(const char* path) {
+        FILE* file = std::fopen(path, "rb");
+        if (!file) return false;
+        uint32_t header[5];
+        bool ok = std::fread(header, sizeof(header), 1, file) == 1 &&
+                  header[0] == REPLAY_MAGIC && header[1] == REPLAY_VERSION;
+        if (ok) {
+            // The input count comes from the file, so it must fit in what the file holds
+            // before anything is allocated for it
+            long start = std::ftell(file);
+            ok = start >= 0 && std::fseek(file, 0, SEEK_END) == 0;
+            long end = ok ? std::ftell(file) : -1;
+            ok = ok && end >= start && header[3] <= static_cast<unsigned long>(end - start) &&
+                 std::fseek(file, start, SEEK_SET) == 0;
+        }
+        if (ok) {
+            seed = header[2];
+            finalScore = static_cast<int32_t>(header[4]);
+            inputs.resize(header[3]);
+            ok = inputs.empty() || std::fread(inputs.data(), inputs.size(), 1, file) == 1;
+        }
+        std::fclose(file);
+        return ok;
+    }
+
+    bool save(const char* path) const {
+        FILE* file = std::fopen(path, "wb");
+        if (!file) return false;
+        const uint32_t header[5] = {REPLAY_MAGIC, REPLAY_VERSION, seed, static_cast<uint32_t>(inputs.size()),
+                                    static_cast<uint32_t>(finalScore)};
+        bool ok = std::fwrite(header, sizeof(header), 1, file) == 1 &&
+                  (inputs.empty() || std::fwrite(inputs.data(), inputs.size(), 1, file) == 1);
+        std::fclose(file);
+        return ok;
+    }
+};
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "tetromino.h"
+
+// Rule sets for BasicTetrisEngine. Each policy is a type with static functions, so an
+// engine built from them has its rules inlined and constant-folded instead of checking
+// a mode on every move.
+//
+// Scoring:  linePoints(lines, level), dropPoints(cells, hard)
+// Leveling: level(totalLines), fallSpeed(level) in milliseconds per row
+// Rotation: spawn(piece) sets the spawn shape, rotate(game) turns the falling piece
+//           clockwise (with kicks) and returns whether it turned
+
+// Classic rules: what the game has always played
+
+struct ClassicScoring {
+    static int linePoints(int lines, int level) {
+        // More points for clearing multiple lines at once
+        static const int pointsForLines[5] = {0, 40, 100, 300, 1200};
+        return pointsForLines[lines] * level;
+    }
+
+    static int dropPoints(int, bool) {
+        return 0;
+    }
+};
+
+struct ClassicLeveling {
+    // Every 5 lines, increase level
+    static int level(int totalLines) {
+        return 1 + totalLines / 5;
+    }
+
+    static int fallSpeed(int level) {
+        return 1000 / level;
+    }
+};
+
+struct ClassicRotation {
+    static void spawn(Tetromino&) {}
+
+    // Rotation around the piece's center, then shifts of 1 and 2 columns either way
+    template <typename Engine>
+    static bool rotate(Engine& game) {
+        // Save the original shape in case we need to revert
+        auto originalShape = game.currentPiece.shape;
+        game.currentPiece.rotate();
+        if (!game.collision()) return true;
+
+        const int kicks[4] = {1, -1, 2, -2}; // Right, left, 2 right, 2 left
+        for (int kick : kicks) {
+            game.pieceX += kick;
+            if (!game.collision()) return true;
+            game.pieceX -= kick; // Revert the kick
+        }
+
+        // If all kicks failed, revert the rotation
+        game.currentPiece.shape = originalShape;
+        return false;
+    }
+};
+
+// Guideline rules: modern scoring, 10 lines per level and SRS rotation
+
+struct GuidelineScoring {
+    static int linePoints(int lines, int level) {
+        static const int pointsForLines[5] = {0, 100, 300, 500, 800};
+        return pointsForLines[lines] * level;
+    }
+
+    // 1 point per row soft dropped, 2 per row hard dropped
+    static int dropPoints(int cells, bool hard) {
+        return cells << static_cast<int>(hard);
+    }
+};
+
+struct GuidelineLeveling {
+    static int level(int totalLines) {
+        return 1 + totalLines / 10;
+    }
+
+    // (0.8 - (level - 1) * 0.007) ^ (level - 1) seconds, held at level 15's speed after that
+    static int fallSpeed(int level) {
+        static const int speeds[15] = {1000, 793, 618, 473, 355, 262, 190, 135, 94, 64, 43, 28, 18, 11, 7};
+        return speeds[std::min(level, 15) - 1];
+    }
+};
+
+// Super Rotation System: pieces turn inside a fixed 3x3 box (4x4 for I) and try the
+// standard five kick offsets. Shapes are kept relative to pieceX - 1 so the box spawns
+// over columns 3-5 like the guideline, and the engine's y-down grid flips the usual
+// table's y offsets.
+struct SrsRotation {
+    static void spawn(Tetromino& piece) {
+        static const Tetromino::Shape shapes[7] = {
+            {{{0, 0}, {1, 0}, {0, 1}, {1, 1}}},   // O
+            {{{-1, 1}, {0, 1}, {1, 1}, {2, 1}}},  // I
+            {{{0, 0}, {1, 0}, {-1, 1}, {0, 1}}},  // S
+            {{{-1, 0}, {0, 0}, {0, 1}, {1, 1}}},  // Z
+            {{{1, 0}, {-1, 1}, {0, 1}, {1, 1}}},  // L
+            {{{-1, 0}, {-1, 1}, {0, 1}, {1, 1}}}, // J
+            {{{0, 0}, {-1, 1}, {0, 1}, {1, 1}}},  // T
+        };
+        piece.shape = shapes[static_cast<int>(piece.type)];
+    }
+
+    template <typename Engine>
+    static bool rotate(Engine& game) {
+        Tetromino::Type type = game.currentPiece.type;
+        if (type == Tetromino::Type::O) return true;
+
+        // Kicks for leaving each orientation clockwise, as (x, y) with y down
+        static const int kicks[2][4][5][2] = {
+            {   // J, L, S, T, Z
+                {{0, 0}, {-1, 0}, {-1, -1}, {0, 2}, {-1, 2}},
+                {{0, 0}, {1, 0}, {1, 1}, {0, -2}, {1, -2}},
+                {{0, 0}, {1, 0}, {1, -1}, {0, 2}, {1, 2}},
+                {{0, 0}, {-1, 0}, {-1, 1}, {0, -2}, {-1, -2}},
+            },
+            {   // I
+                {{0, 0}, {-2, 0}, {1, 0}, {-2, 1}, {1, -2}},
+                {{0, 0}, {-1, 0}, {2, 0}, {-1, -2}, {2, 1}},
+                {{0, 0}, {2, 0}, {-1, 0}, {2, -1}, {-1, 2}},
+                {{0, 0}, {1, 0}, {-2, 0}, {1, 2}, {-2, -1}},
+            },
+        };
+
+        auto originalShape = game.currentPiece.shape;
+        int box = type == Tetromino::Type::I ? 4 : 3;
+        for (auto& block : game.currentPiece.shape) {
+            // Clockwise turn inside the box, whose left edge is one column left of pieceX
+            int x = block.x + 1;
+            block = {box - 1 - block.y - 1, x};
+        }
+
+        const int (*tests)[2] = kicks[type == Tetromino::Type::I][game.rotation];
+        for (int i = 0; i < 5; i++) {
+            game.pieceX += tests[i][0];
+            game.pieceY += tests[i][1];
+            if (!game.collision()) return true;
+            game.pieceX -= tests[i][0];
+            game.pieceY -= tests[i][1];
+        }
+        game.currentPiece.shape = originalShape;
+        return false;
+    }
+};
+
+// House rules: classic feel with a softer speed curve, points for soft drops and a
+// floor kick when the classic side kicks all fail
+
+struct HouseScoring {
+    static int linePoints(int lines, int level) {
+        static const int pointsForLines[5] = {0, 100, 250, 500, 1000};
+        return pointsForLines[lines] * level;
+    }
+
+    static int dropPoints(int cells, bool hard) {
+        return hard ? 0 : cells;
+    }
+};
+
+struct HouseLeveling {
+    static int level(int totalLines) {
+        return 1 + totalLines / 8;
+    }
+
+    // 75 ms faster per level, never under 100 ms
+    static int fallSpeed(int level) {
+        return std::max(100, 1075 - 75 * level);
+    }
+};
+
+struct HouseRotation {
+    static void spawn(Tetromino&) {}
+
+    // The classic rotation in place, then once more a row up. One call site, so the
+    // classic kicks are inlined once rather than twice into every rotatePiece().
+    template <typename Engine>
+    static bool rotate(Engine& game) {
+        for (int lift = 0; lift <= 1 && lift <= game.pieceY; lift++) {
+            game.pieceY -= lift;
+            if (ClassicRotation::rotate(game)) return true;
+            game.pieceY += lift;
+        }
+        return false;
+    }
+};
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "tetris_engine.h"
+
+// Idle games packed into fixed-size records, for keeping very many paused or inactive
+// sessions in memory. An engine is a few hundred bytes of wide ints, two Tetrominos and
+// a byte per cell; a record keeps the same state in 136 bytes:
+//
+//   cells       4 bits per cell, two to a byte. Cells hold console colors, which are
+//               all below 16, and the colors are kept because rendering and
+//               hashState() see them.
+//   shape       The falling piece's four blocks as signed 4-bit x/y pairs, since a
+//               rotated shape depends on the rotation system and the kicks it took
+//   counters    score, lines, ticks, pieces and the random state at 32 bits, the level,
+//               fall speed and fall timer at 16
+//   bits        Piece type indices, game state, rotation and lines just cleared
+//
+// The next piece is stored as its type and rebuilt with the engine's spawn rule.
+// Attached listeners, choosers and probes aren't part of a session; hydrating leaves
+// whatever the target engine has, and a listener should be refreshed afterwards.
+static_assert(GRID_HEIGHT * GRID_WIDTH % 8 == 0, "cells are packed eight at a time");
+
+struct CompactGame {
+    uint8_t cells[GRID_HEIGHT * GRID_WIDTH / 2];
+    int32_t score;
+    int32_t linesCleared;
+    uint32_t ticks;
+    uint32_t pieces;
+    uint32_t randomState;
+    uint32_t shape;
+    uint16_t level;
+    uint16_t fallSpeed;
+    uint16_t fallTimer;
+    int8_t pieceX;
+    int8_t pieceY;
+    uint16_t bits; // current type:3, next type:3, state:2, rotation:2, lines just cleared:4, in use:1
+};
+
+static_assert(sizeof(CompactGame) == 136, "records are packed without gaps");
+
+const uint16_t COMPACT_IN_USE = 1 << 14;
+
+template <typename Engine>
+void packGame(const Engine& game, CompactGame& out) {
+    // Eight cells at a time: each odd cell's nibble joins the even cell before it, then
+    // the even bytes are gathered
+    const uint8_t* cells = &game.grid[0][0];
+    for (int i = 0; i < GRID_HEIGHT * GRID_WIDTH; i += 8) {
+        uint64_t v;
+        std::memcpy(&v, cells + i, 8);
+        v &= 0x0f0f0f0f0f0f0f0full;
+        v = (v | v >> 4) & 0x00ff00ff00ff00ffull;
+        v = (v | v >> 8) & 0x0000ffff0000ffffull;
+        uint32_t packed = static_cast<uint32_t>(v | v >> 16);
+        std::memcpy(out.cells + i / 2, &packed, 4);
+    }
+    out.score = game.score;
+    out.linesCleared = game.linesCleared;
+    out.ticks = game.ticks;
+    out.pieces = game.pieces;
+    out.randomState = game.random.state;
+    out.shape = 0;
+    for (int i = 0; i < 4; i++) {
+        const Tetromino::Position& block = game.currentPiece.shape[i];
+        out.shape |= static_cast<uint32_t>((block.x & 15) | (block.y & 15) << 4) << (8 * i);
+    }
+    out.level = static_cast<uint16_t>(game.level);
+    out.fallSpeed = static_cast<uint16_t>(game.fallSpeed);
+    out.fallTimer = static_cast<uint16_t>(game.fallTimer);
+    out.pieceX = static_cast<int8_t>(game.pieceX);
+    out.pieceY = static_cast<int8_t>(game.pieceY);
+    out.bits = static_cast<uint16_t>(static_cast<int>(game.currentPiece.type) | static_cast<int>(game.nextPiece.type) << 3 |
+                                     static_cast<int>(game.gameState) << 6 | (game.rotation & 3) << 8 |
+                                     (game.linesJustCleared & 15) << 10 | COMPACT_IN_USE);
+}
+
+template <typename Engine>
+void unpackGame(const CompactGame& in, Engine& game) {
+    uint8_t* cells = &game.grid[0][0];
+    for (int i = 0; i < GRID_HEIGHT * GRID_WIDTH; i += 8) {
+        uint32_t packed;
+        std::memcpy(&packed, in.cells + i / 2, 4);
+        uint64_t v = packed;
+        v = (v | v << 16) & 0x0000ffff0000ffffull;
+        v = (v | v << 8) & 0x00ff00ff00ff00ffull;
+        v = (v & 0x000f000f000f000full) | (v & 0x00f000f000f000f0ull) << 4;
+        std::memcpy(cells + i, &v, 8);
+    }
+    game.score = in.score;
+    game.linesCleared = in.linesCleared;
+    game.ticks = in.ticks;
+    game.pieces = in.pieces;
+    game.random.state = in.randomState;
+
+    game.currentPiece = Tetromino(static_cast<Tetromino::Type>(in.bits & 7));
+    for (int i = 0; i < 4; i++) {
+        // Sign-extend each 4-bit coordinate
+        int x = (in.shape >> (8 * i)) & 15;
+        int y = (in.shape >> (8 * i + 4)) & 15;
+        game.currentPiece.shape[i] = {x < 8 ? x : x - 16, y < 8 ? y : y - 16};
+    }
+    game.nextPiece = Tetromino(static_cast<Tetromino::Type>((in.bits >> 3) & 7));
+    Engine::RotationRules::spawn(game.nextPiece);
+
+    game.level = in.level;
+    game.fallSpeed = in.fallSpeed;
+    game.fallTimer = in.fallTimer;
+    game.pieceX = in.pieceX;
+    game.pieceY = in.pieceY;
+    game.gameState = static_cast<GameState>((in.bits >> 6) & 3);
+    game.rotation = (in.bits >> 8) & 3;
+    game.linesJustCleared = (in.bits >> 10) & 15;
+}
+
+// Records in one contiguous slab. Released records are chained into a free list through
+// their first bytes and reused before the slab grows, so ids stay small and stable and
+// a store that has reached its peak size never allocates again.
+template <typename Engine = TetrisEngine>
+class SessionStore {
+public:
+    static const uint32_t NONE = 0xffffffffu;
+
+    explicit SessionStore(size_t reserve = 0) : freeHead(NONE), live(0) {
+        slab.reserve(reserve);
+    }
+
+    // Packs the game into a free record and returns its id
+    uint32_t dehydrate(const Engine& game) {
+        uint32_t id = freeHead;
+        if (id == NONE) {
+            id = static_cast<uint32_t>(slab.size());
+            slab.emplace_back();
+        } else {
+            std::memcpy(&freeHead, slab[id].cells, sizeof(freeHead));
+        }
+        packGame(game, slab[id]);
+        live++;
+        return id;
+    }
+
+    // Writes a changed game back over its record
+    void update(uint32_t id, const Engine& game) {
+        packGame(game, slab[id]);
+    }
+
+    // Restores the game into `game`; the record stays until released
+    void hydrate(uint32_t id, Engine& game) const {
+        unpackGame(slab[id], game);
+    }
+
+    // Frees the record for reuse. A stale id or a second release is refused: linking the
+    // same record into the free list twice would hand it to two sessions.
+    bool release(uint32_t id) {
+        if (!contains(id)) return false;
+        slab[id].bits = 0;
+        std::memcpy(slab[id].cells, &freeHead, sizeof(freeHead));
+        freeHead = id;
+        live--;
+        return true;
+    }
+
+    bool contains(uint32_t id) const {
+        return id < slab.size() && (slab[id].bits & COMPACT_IN_USE);
+    }
+
+    size_t size() const {
+        return live;
+    }
+
+    // Bytes held by the slab, free records included
+    size_t bytes() const {
+        return slab.capacity() * sizeof(CompactGame);
+    }
+
+private:
+    std::vector<CompactGame> slab;
+    uint32_t freeHead;
+    size_t live;
+};
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "board_eval.h"
+#include "tetris_env.h"
+
+// How many more pieces a position survives when the next piece is always the worst one.
+//
+// Min/max search: the adversary picks one of the 7 piece types, the player answers with
+// the best hard-drop placement, repeated up to a depth. Alpha-beta bounds cut most of
+// the tree: the player's placements are tried best-heuristic first, and the first one
+// that survives to the depth ends the node. Iterative deepening stops as soon as the
+// adversary has a forced top-out, since searching deeper can't change that count.
+//
+// A piece tops out once the stack reaches the spawn area (columns 3-6 of the top four
+// rows, where every piece spawns). That is a little stricter than the engine's exact
+// spawn collision, but it's left-right symmetric, so a board and its mirror image are
+// worth the same (S/Z and L/J swap, and the adversary may pick any of them anyway).
+// The memo stores boards in canonical orientation and so serves both.
+const int SURVIVAL_MAX_DEPTH = 8;
+const uint16_t SPAWN_AREA_ROW = 0x78; // Columns 3-6
+const int SPAWN_AREA_ROWS = 4;
+
+// Order the adversary tries pieces in: the ones that kill most often first
+const Tetromino::Type ADVERSARY_ORDER[PIECE_TYPES] = {
+    Tetromino::Type::S, Tetromino::Type::Z, Tetromino::Type::O, Tetromino::Type::I,
+    Tetromino::Type::T, Tetromino::Type::L, Tetromino::Type::J,
+};
+
+inline bool spawnAreaFilled(const Board& board) {
+    for (int y = 0; y < SPAWN_AREA_ROWS; y++) {
+        if (board.rows[y] & SPAWN_AREA_ROW) return true;
+    }
+    return false;
+}
+
+inline uint16_t mirrorRow(uint16_t row) {
+    static const struct Table {
+        uint16_t values[1 << GRID_WIDTH];
+        Table() {
+            for (int row = 0; row < (1 << GRID_WIDTH); row++) {
+                values[row] = 0;
+                for (int x = 0; x < GRID_WIDTH; x++) {
+                    if (row & (1 << x)) values[row] |= 1 << (GRID_WIDTH - 1 - x);
+                }
+            }
+        }
+    } table;
+    return table.values[row];
+}
+
+// The board or its mirror image, whichever has the smaller rows from the bottom up
+inline Board canonicalBoard(const Board& board) {
+    Board mirrored;
+    for (int y = 0; y < GRID_HEIGHT; y++) {
+        mirrored.rows[y] = mirrorRow(board.rows[y]);
+    }
+    for (int y = GRID_HEIGHT - 1; y >= 0; y--) {
+        if (board.rows[y] != mirrored.rows[y]) {
+            return board.rows[y] < mirrored.rows[y] ? board : mirrored;
+        }
+    }
+    return board;
+}
+
+struct SurvivalResult {
+    int pieces;        // Pieces survived against the worst sequence, up to `depth`
+    bool forced;       // The adversary forces a top-out after `pieces`, searching deeper won't help
+    int depth;         // Deepest search completed
+    uint64_t nodes;
+    double seconds;
+};
+
+class SurvivalAnalyzer {
+public:
+    // threads > 1 searches the adversary's root choices in parallel.
+    // The memo has 2^tableBits entries of 44 bytes, shared by all threads.
+    explicit SurvivalAnalyzer(int threads = 1, int tableBits = 18)
+        : pool(threads), table(size_t(1) << tableBits), mask((size_t(1) << tableBits) - 1),
+          contexts(threads > 1 ? PIECE_TYPES : 1), nodes(0), stopping(false) {}
+
+    // Deepens until a forced top-out is found, maxDepth is reached or the time budget
+    // (if any) runs out; an unfinished iteration is discarded
+    SurvivalResult analyze(const Board& board, int maxDepth, double budgetSeconds = 0) {
+        auto start = std::chrono::steady_clock::now();
+        deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                               std::chrono::duration<double>(budgetSeconds));
+        hasDeadline = budgetSeconds > 0;
+        stopping.store(false);
+        nodes.store(0);
+
+        SurvivalResult result = {0, false, 0, 0, 0};
+        maxDepth = std::min(maxDepth, SURVIVAL_MAX_DEPTH);
+        for (int depth = 1; depth <= maxDepth; depth++) {
+            int value = searchRoot(board, depth);
+            if (stopping.load()) break;
+            result.pieces = value;
+            result.depth = depth;
+            if (value < depth) {
+                result.forced = true;
+                break;
+            }
+        }
+        result.nodes = nodes.load();
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+    // Forget every memoized position, e.g. between unrelated games
+    void clearMemo() {
+        std::fill(table.begin(), table.end(), MemoEntry());
+    }
+
+private:
+    struct MemoEntry {
+        Board board;
+        int8_t depth = -1;  // -1 marks an empty slot
+        int8_t lower = 0;   // Value bounds for a search of `depth`
+        int8_t upper = 0;
+    };
+
+    // Scratch space for one searching thread, one level per ply so nothing is allocated
+    struct Context {
+        BoardSet sets[SURVIVAL_MAX_DEPTH + 1];
+        BoardFeatures features[SURVIVAL_MAX_DEPTH + 1];
+    };
+
+    static const int LOCK_STRIPES = 64;
+
+    ShardPool pool;
+    std::vector<MemoEntry> table;
+    size_t mask;
+    std::mutex locks[LOCK_STRIPES];
+    std::vector<Context> contexts;
+    std::atomic<uint64_t> nodes;
+    std::atomic<bool> stopping;
+    bool hasDeadline;
+    std::chrono::steady_clock::time_point deadline;
+
+    // Root adversary node with each piece type searched as its own job
+    int searchRoot(const Board& board, int depth) {
+        if (spawnAreaFilled(board)) return 0;
+        if (pool.threads() == 1) {
+            int best = depth;
+            for (int i = 0; i < PIECE_TYPES && best > 0; i++) {
+                best = std::min(best, player(contexts[0], board, ADVERSARY_ORDER[i], depth, 0, best));
+            }
+            return best;
+        }
+
+        // Jobs may run on any thread, so each piece type gets its own scratch context
+        int values[PIECE_TYPES];
+        auto job = [&](int i) {
+            values[i] = player(contexts[i], board, ADVERSARY_ORDER[i], depth, 0, depth);
+        };
+        pool.run(PIECE_TYPES, job);
+        return *std::min_element(values, values + PIECE_TYPES);
+    }
+
+    // Adversary to move: the worst piece for the player, in [0, depth]
+    int adversary(Context& context, const Board& board, int depth, int alpha, int beta) {
+        if (depth == 0 || spawnAreaFilled(board)) return 0;
+        if ((nodes.fetch_add(1, std::memory_order_relaxed) & 1023) == 0 && hasDeadline &&
+            std::chrono::steady_clock::now() > deadline) {
+            stopping.store(true);
+        }
+        if (stopping.load(std::memory_order_relaxed)) return 0;
+
+        Board key = canonicalBoard(board);
+        size_t slot = hashBoard(key) & mask;
+        {
+            std::lock_guard<std::mutex> lock(locks[slot % LOCK_STRIPES]);
+            const MemoEntry& entry = table[slot];
+            if (entry.depth >= 0 && entry.board == key) {
+                // A forced top-out found at any depth holds for every deeper one
+                bool forced = entry.lower == entry.upper && entry.upper < entry.depth;
+                if (entry.depth == depth || forced) {
+                    if (entry.lower >= beta || entry.lower == entry.upper) return std::min<int>(entry.lower, depth);
+                    if (entry.upper <= alpha) return entry.upper;
+                    alpha = std::max<int>(alpha, entry.lower);
+                    beta = std::min<int>(beta, entry.upper);
+                }
+            }
+        }
+
+        int originalAlpha = alpha;
+        int value = depth;
+        for (int i = 0; i < PIECE_TYPES && value > alpha; i++) {
+            value = std::min(value, player(context, board, ADVERSARY_ORDER[i], depth, alpha, std::min(beta, value)));
+        }
+        if (stopping.load(std::memory_order_relaxed)) return 0;
+
+        // Inside the window `value` is exact. At or above beta every piece was cut off, so
+        // it's only a lower bound; at or below alpha it's only an upper bound.
+        std::lock_guard<std::mutex> lock(locks[slot % LOCK_STRIPES]);
+        MemoEntry& entry = table[slot];
+        entry.board = key;
+        entry.depth = static_cast<int8_t>(depth);
+        if (value >= beta) {
+            entry.lower = static_cast<int8_t>(beta);
+            entry.upper = static_cast<int8_t>(depth);
+        } else {
+            entry.lower = static_cast<int8_t>(value > originalAlpha ? value : 0);
+            entry.upper = static_cast<int8_t>(value);
+        }
+        return value;
+    }
+
+    // Player to place `type`: the best placement's count, 1 for the piece itself plus what
+    // follows. Stops at the first placement that reaches beta.
+    int player(Context& context, const Board& board, Tetromino::Type type, int depth, int alpha, int beta) {
+        Placement placements[MAX_PLACEMENTS];
+        int count = enumeratePlacements(board, type, placements);
+        if (count == 0) return 0;
+
+        // Most promising placements first, by the usual heuristic
+        BoardSet& set = context.sets[depth];
+        BoardFeatures& features = context.features[depth];
+        set.clear();
+        for (int i = 0; i < count; i++) {
+            set.add(applyPlacement(board, placements[i]));
+        }
+        evaluateBoards(set, features);
+        float scores[MAX_PLACEMENTS];
+        int order[MAX_PLACEMENTS];
+        EvalWeights weights;
+        for (int i = 0; i < count; i++) {
+            scores[i] = scoreFeatures(features, i, weights);
+            order[i] = i;
+        }
+        std::sort(order, order + count, [&](int a, int b) { return scores[a] > scores[b]; });
+
+        int best = 0;
+        for (int i = 0; i < count && best < beta; i++) {
+            Board child = set.get(order[i]);
+            child.clearLines();
+            int value = 1 + adversary(context, child, depth - 1, std::max(alpha, best) - 1, beta - 1);
+            best = std::max(best, value);
+        }
+        return best;
+    }
+
+    static uint64_t hashBoard(const Board& board) {
+        StateHasher h;
+        for (int y = 0; y < GRID_HEIGHT; y += 2) {
+            h.add(board.rows[y] | static_cast<uint32_t>(board.rows[y + 1]) << 16);
+        }
+        return h.hash ^ (h.hash >> 29);
+    }
+};
@@ -0,0 +1,456 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include "board.h"
+#include "rules.h"
+
+// Game state
+enum class GameState {
+    PLAYING,
+    GAME_OVER,
+    RESTART
+};
+
+// One player action per frame
+enum class Input : uint8_t {
+    NONE,
+    LEFT,
+    RIGHT,
+    ROTATE,
+    SOFT_DROP,
+    HARD_DROP
+};
+
+const int INPUT_COUNT = 6;
+
+// Length of one frame of the game loop in milliseconds (the Sleep(50) in TetrisGame::run())
+const int FRAME_MS = 50;
+
+// Small deterministic random generator so every game can be replayed from its seed
+struct PieceRandom {
+    uint32_t state;
+
+    void seed(uint32_t value) {
+        // xorshift must never hold zero
+        state = value ? value : 0x9e3779b9u;
+    }
+
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+};
+
+// Picks the engine's next pieces instead of the random generator (see adversarial_chooser.h).
+// `board` is the grid after the latest lock, which `current` is about to fall into;
+// `random` is the engine's own generator, for choices that should stay replayable.
+class PieceChooser {
+public:
+    virtual ~PieceChooser() {}
+    virtual Tetromino::Type choosePiece(const Board& board, Tetromino::Type current, PieceRandom& random) = 0;
+};
+
+// Stages of a tick, for profiling (see perf_counters.h). RENDER is the caller drawing
+// the new state and never comes from the engine itself.
+enum class TickPhase : uint8_t {
+    INPUT,
+    GRAVITY,
+    LOCK,
+    LINE_CLEAR,
+    RENDER
+};
+
+const int TICK_PHASES = 5;
+
+// Told as the engine enters and leaves each phase of a tick. Phases nest: a lock and
+// its line clear happen inside the input (hard drop) or gravity phase that caused them.
+class TickProbe {
+public:
+    virtual ~TickProbe() {}
+    virtual void enter(TickPhase phase) = 0;
+    virtual void leave() = 0;
+};
+
+// The game without any console code: grid, pieces, scoring and gravity.
+// Everything advances through tick(), one frame at a time, so the same seed and
+// inputs always produce the same game. Scoring, leveling and rotation come from the
+// policy types in rules.h; TetrisEngine below is the classic rule set.
+template <typename Scoring, typename Leveling, typename Rotation>
+class BasicTetrisEngine {
+public:
+    typedef Scoring ScoringRules;
+    typedef Leveling LevelingRules;
+    typedef Rotation RotationRules;
+
+    explicit BasicTetrisEngine(uint32_t seed = 1) {
+        reset(seed);
+    }
+
+    void reset(uint32_t seed) {
+        // Clear the grid
+        for (int y = 0; y < GRID_HEIGHT; y++) {
+            for (int x = 0; x < GRID_WIDTH; x++) {
+                grid[y][x] = 0;
+            }
+        }
+        if (listener) {
+            listener->gridReset();
+        }
+
+        // Reset game variables
+        random.seed(seed);
+        currentPiece = getRandomPiece();
+        nextPiece = getRandomPiece();
+        pieceX = GRID_WIDTH / 2 - 1;
+        pieceY = 0;
+        rotation = 0;
+        score = 0;
+        level = 1;
+        linesCleared = 0;
+        gameState = GameState::PLAYING;
+        fallSpeed = Leveling::fallSpeed(level); // Initial falling speed in milliseconds
+        fallTimer = 0;
+        ticks = 0;
+        pieces = 1;
+        linesJustCleared = 0;
+    }
+
+    // Advances one frame: the player's input first, then gravity if it's due
+    void tick(Input input) {
+        if (gameState != GameState::PLAYING) return;
+        ticks++;
+        linesJustCleared = 0;
+        if (probe) probe->enter(TickPhase::INPUT);
+
+        switch (input) {
+        case Input::LEFT:
+            movePieceLeft();
+            break;
+        case Input::RIGHT:
+            movePieceRight();
+            break;
+        case Input::ROTATE:
+            rotatePiece();
+            break;
+        case Input::SOFT_DROP:
+            softDrop();
+            break;
+        case Input::HARD_DROP:
+            hardDrop();
+            break;
+        case Input::NONE:
+            break;
+        }
+
+        if (probe) {
+            probe->leave();
+            probe->enter(TickPhase::GRAVITY);
+        }
+
+        // Check if it's time for the piece to fall
+        fallTimer += FRAME_MS;
+        if (gameState == GameState::PLAYING && fallTimer >= fallSpeed) {
+            movePieceDown();
+            fallTimer = 0;
+        }
+        if (probe) probe->leave();
+    }
+
+    // Pushes the stack up by `lines` rows of garbage, each with one empty cell at holeColumn.
+    // Blocks pushed off the top end the game, the same as a blocked spawn.
+    void addGarbage(int lines, int holeColumn) {
+        for (int i = 0; i < lines; i++) {
+            for (int x = 0; x < GRID_WIDTH; ++x) {
+                if (grid[0][x] != 0) {
+                    gameState = GameState::GAME_OVER;
+                }
+            }
+            for (int y = 0; y < GRID_HEIGHT - 1; ++y) {
+                for (int x = 0; x < GRID_WIDTH; ++x) {
+                    grid[y][x] = grid[y + 1][x];
+                }
+            }
+            for (int x = 0; x < GRID_WIDTH; ++x) {
+                grid[GRID_HEIGHT - 1][x] = x == holeColumn ? 0 : COLOR_GARBAGE;
+            }
+        }
+
+        if (listener) {
+            // Every row moved, so a rebuild is as cheap as anything incremental
+            listener->gridReset();
+            for (int y = 0; y < GRID_HEIGHT; y++) {
+                for (int x = 0; x < GRID_WIDTH; x++) {
+                    if (grid[y][x] != 0) listener->cellSet(x, y);
+                }
+            }
+        }
+
+        // The falling piece rides up with the stack if it now overlaps it
+        while (collision() && pieceY > 0) {
+            pieceY--;
+        }
+        if (collision()) {
+            gameState = GameState::GAME_OVER;
+        }
+    }
+
+    bool gravityDue() const {
+        return fallTimer + FRAME_MS >= fallSpeed;
+    }
+
+    void movePieceLeft() {
+        pieceX--;
+        if (collision()) {
+            pieceX++; // Move back if collision
+        }
+    }
+
+    void movePieceRight() {
+        pieceX++;
+        if (collision()) {
+            pieceX--; // Move back if collision
+        }
+    }
+
+    void rotatePiece() {
+        if (Rotation::rotate(*this)) {
+            rotation = (rotation + 1) & 3;
+        }
+    }
+
+    void movePieceDown() {
+        pieceY++;
+        if (collision()) {
+            pieceY--; // Move back up if collision
+            lockPiece(); // Lock the piece in place
+            clearLines(); // Check and clear any full lines
+            spawnNewPiece(); // Spawn a new piece
+        }
+    }
+
+    // A player's soft drop; unlike gravity it can score
+    void softDrop() {
+        uint32_t before = pieces;
+        movePieceDown();
+        if (pieces == before) {
+            score += Scoring::dropPoints(1, false);
+        }
+    }
+
+    void hardDrop() {
+        // Keep moving down until collision
+        int startY = pieceY;
+        while (!collision()) {
+            pieceY++;
+        }
+        pieceY--; // Move back up from the collision position
+        score += Scoring::dropPoints(pieceY - startY, true);
+        lockPiece(); // Lock the piece in place
+        clearLines(); // Check and clear any full lines
+        spawnNewPiece(); // Spawn a new piece
+    }
+
+    bool collision() const {
+        for (const auto& pos : currentPiece.getGlobalPositions(pieceX, pieceY)) {
+            // Check boundaries
+            if (pos.x < 0 || pos.x >= GRID_WIDTH || pos.y < 0 || pos.y >= GRID_HEIGHT) {
+                return true;
+            }
+
+            // Check collision with locked pieces
+            if (grid[pos.y][pos.x] != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Game grid (0 = empty, other values = filled with color)
+    uint8_t grid[GRID_HEIGHT][GRID_WIDTH];
+
+    // Current falling piece
+    Tetromino currentPiece;
+    int pieceX, pieceY;
+    int rotation; // Clockwise quarter turns since spawn, 0-3
+
+    // Next piece to appear
+    Tetromino nextPiece;
+
+    // Game state variables
+    int score;
+    int level;
+    int linesCleared;
+    GameState gameState;
+    int fallSpeed;
+    int fallTimer; // Milliseconds since the piece last fell
+    uint32_t ticks;
+    uint32_t pieces; // Pieces spawned so far, changes whenever a new piece appears
+    int linesJustCleared; // Lines cleared during the latest tick
+    PieceRandom random;
+
+    // Optional observer of grid changes (for example the NNUE accumulator)
+    GridListener* listener = nullptr;
+
+    // Optional source of the pieces after the first two; random when unset
+    PieceChooser* chooser = nullptr;
+
+    // Optional profiler hook, told about every phase of tick()
+    TickProbe* probe = nullptr;
+
+private:
+    Tetromino getRandomPiece() {
+        // Create a random tetromino
+        int randPiece = random.next() % 7;
+        return makePiece(static_cast<Tetromino::Type>(randPiece));
+    }
+
+    Tetromino makePiece(Tetromino::Type type) {
+        Tetromino piece(type);
+        Rotation::spawn(piece);
+        return piece;
+    }
+
+    void lockPiece() {
+        if (probe) probe->enter(TickPhase::LOCK);
+        for (const auto& pos : currentPiece.getGlobalPositions(pieceX, pieceY)) {
+            if (pos.y >= 0 && pos.y < GRID_HEIGHT && pos.x >= 0 && pos.x < GRID_WIDTH) {
+                if (listener && grid[pos.y][pos.x] == 0) {
+                    listener->cellSet(pos.x, pos.y);
+                }
+                grid[pos.y][pos.x] = static_cast<uint8_t>(currentPiece.color);
+            }
+        }
+        if (probe) probe->leave();
+    }
+
+    void clearLines() {
+        if (probe) probe->enter(TickPhase::LINE_CLEAR);
+        int linesCleared = 0;
+
+        for (int y = GRID_HEIGHT - 1; y >= 0; --y) {
+            bool lineFilled = true;
+
+            // Check if this line is completely filled
+            for (int x = 0; x < GRID_WIDTH; ++x) {
+                if (grid[y][x] == 0) {
+                    lineFilled = false;
+                    break;
+                }
+            }
+
+            if (lineFilled) {
+                linesCleared++;
+
+                if (listener) {
+                    listener->rowCleared(Board::fromGrid(grid), y);
+                }
+
+                // Move all lines above this one down
+                for (int moveY = y; moveY > 0; --moveY) {
+                    for (int x = 0; x < GRID_WIDTH; ++x) {
+                        grid[moveY][x] = grid[moveY - 1][x];
+                    }
+                }
+
+                // Clear the top line
+                for (int x = 0; x < GRID_WIDTH; ++x) {
+                    grid[0][x] = 0;
+                }
+
+                // Since we've moved all lines down, we need to check this y-index again
+                y++;
+            }
+        }
+
+        // Update score and level
+        if (linesCleared > 0) {
+            updateScoreAndLevel(linesCleared);
+        }
+        linesJustCleared += linesCleared;
+        if (probe) probe->leave();
+    }
+
+    void updateScoreAndLevel(int lines) {
+        // Add points based on the number of lines and current level
+        score += Scoring::linePoints(lines, level);
+
+        // Update total lines cleared
+        this->linesCleared += lines;
+
+        level = Leveling::level(this->linesCleared);
+
+        // Increase speed as level increases
+        fallSpeed = Leveling::fallSpeed(level);
+    }
+
+    void spawnNewPiece() {
+        // Set the current piece to the next piece
+        currentPiece = nextPiece;
+
+        // Generate a new next piece
+        if (chooser) {
+            nextPiece = makePiece(chooser->choosePiece(Board::fromGrid(grid), currentPiece.type, random));
+        } else {
+            nextPiece = getRandomPiece();
+        }
+
+        // Reset position
+        pieceX = GRID_WIDTH / 2 - 1;
+        pieceY = 0;
+        rotation = 0;
+        pieces++;
+
+        // Check for game over
+        if (collision()) {
+            gameState = GameState::GAME_OVER;
+        }
+    }
+};
+
+typedef BasicTetrisEngine<ClassicScoring, ClassicLeveling, ClassicRotation> TetrisEngine;
+typedef BasicTetrisEngine<GuidelineScoring, GuidelineLeveling, SrsRotation> GuidelineEngine;
+typedef BasicTetrisEngine<HouseScoring, HouseLeveling, HouseRotation> HouseEngine;
+
+// 64-bit hash of everything that decides how a game continues.
+// Two engines with equal hashes will play out identically from the same inputs.
+// The rotation counter is left out: the shape already tells the orientations apart.
+// FNV-1a over 32-bit words instead of bytes, since it runs after every tick in golden_trace.
+struct StateHasher {
+    uint64_t hash = 1469598103934665603ull;
+
+    void add(uint32_t value) {
+        hash ^= value;
+        hash *= 1099511628211ull;
+    }
+};
+
+template <typename Engine>
+uint64_t hashState(const Engine& game) {
+    static_assert(sizeof(game.grid) % 4 == 0, "grid is hashed four cells at a time");
+    StateHasher h;
+    const uint8_t* cells = &game.grid[0][0];
+    for (size_t i = 0; i < sizeof(game.grid); i += 4) {
+        uint32_t word;
+        std::memcpy(&word, cells + i, 4);
+        h.add(word);
+    }
+    h.add(static_cast<uint32_t>(game.currentPiece.type));
+    for (const auto& block : game.currentPiece.shape) {
+        h.add(static_cast<uint32_t>(block.x));
+        h.add(static_cast<uint32_t>(block.y));
+    }
+    h.add(static_cast<uint32_t>(game.pieceX));
+    h.add(static_cast<uint32_t>(game.pieceY));
+    h.add(static_cast<uint32_t>(game.nextPiece.type));
+    h.add(static_cast<uint32_t>(game.score));
+    h.add(static_cast<uint32_t>(game.level));
+    h.add(static_cast<uint32_t>(game.linesCleared));
+    h.add(static_cast<uint32_t>(game.gameState));
+    h.add(static_cast<uint32_t>(game.fallSpeed));
+    h.add(static_cast<uint32_t>(game.fallTimer));
+    h.add(game.random.state);
+    return h.hash;
+}
@@ -0,0 +1,226 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "tetris_engine.h"
+
+// Library API for stepping many independent games in lockstep, e.g. to train agents.
+//
+// Observation for one game, OBS_SIZE bytes:
+//   [0, OBS_CELLS)    grid cells row by row from the top: 0 empty, 1 locked, 2 falling piece
+//   OBS_CELLS         current piece type (Tetromino::Type)
+//   OBS_CELLS + 1     next piece type
+// Actions are Input values, one per game per step; a step is one frame of the game.
+const int OBS_CELLS = GRID_WIDTH * GRID_HEIGHT;
+const int OBS_SIZE = OBS_CELLS + 2;
+
+inline void writeObservation(const TetrisEngine& game, uint8_t* out) {
+    for (int y = 0; y < GRID_HEIGHT; y++) {
+        for (int x = 0; x < GRID_WIDTH; x++) {
+            out[y * GRID_WIDTH + x] = game.grid[y][x] != 0;
+        }
+    }
+    for (const auto& pos : game.currentPiece.getGlobalPositions(game.pieceX, game.pieceY)) {
+        if (pos.y >= 0 && pos.y < GRID_HEIGHT && pos.x >= 0 && pos.x < GRID_WIDTH) {
+            out[pos.y * GRID_WIDTH + pos.x] = 2;
+        }
+    }
+    out[OBS_CELLS] = static_cast<uint8_t>(game.currentPiece.type);
+    out[OBS_CELLS + 1] = static_cast<uint8_t>(game.nextPiece.type);
+}
+
+// Fixed set of worker threads that split a batch of shards with the calling thread.
+// Workers sleep between batches, so an idle pool costs nothing. Each worker copies the
+// batch under the lock before working on it, and run() doesn't start or return while a
+// worker is still inside a batch, so no worker ever mixes up two batches.
+class ShardPool {
+public:
+    explicit ShardPool(int threads) : nextShard(0), pending(0), generation(0), active(0), stopping(false) {
+        for (int i = 1; i < threads; i++) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~ShardPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    ShardPool(const ShardPool&) = delete;
+    ShardPool& operator=(const ShardPool&) = delete;
+
+    int threads() const {
+        return static_cast<int>(workers.size()) + 1;
+    }
+
+    // Calls job(shard) for every shard in [0, count) and returns once all are done.
+    // The job is only borrowed for the call, so there's no std::function or allocation.
+    template <typename Job>
+    void run(int count, Job& job) {
+        if (workers.empty() || count == 1) {
+            for (int shard = 0; shard < count; shard++) {
+                job(shard);
+            }
+            return;
+        }
+        Batch mine;
+        {
+            // A worker that woke up late may still be walking off the previous batch
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [this] { return active == 0; });
+            batch.call = [](void* ctx, int shard) { (*static_cast<Job*>(ctx))(shard); };
+            batch.context = &job;
+            batch.shards = count;
+            nextShard.store(0);
+            pending.store(count);
+            generation++;
+            mine = batch;
+        }
+        wake.notify_all();
+        runShards(mine);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this] { return pending.load() == 0 && active == 0; });
+        batch = Batch();
+    }
+
+private:
+    struct Batch {
+        void (*call)(void*, int) = nullptr;
+        void* context = nullptr;
+        int shards = 0;
+    };
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    Batch batch; // Guarded by mutex
+    std::atomic<int> nextShard;
+    std::atomic<int> pending;
+    uint64_t generation;
+    int active; // Workers inside runShards()
+    bool stopping;
+
+    void runShards(const Batch& work) {
+        for (;;) {
+            int shard = nextShard.fetch_add(1);
+            if (shard >= work.shards) return;
+            work.call(work.context, shard);
+            if (pending.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished.notify_all();
+            }
+        }
+    }
+
+    void workerLoop() {
+        uint64_t seen = 0;
+        for (;;) {
+            Batch work;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                work = batch;
+                active++;
+            }
+            runShards(work);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                active--;
+            }
+            finished.notify_all();
+        }
+    }
+};
+
+// N games stepped in lockstep. Observations, rewards and done flags are written straight
+// into caller-provided contiguous buffers; nothing is allocated after construction.
+class VecEnv {
+public:
+    // threads = 0 uses every core
+    explicit VecEnv(int count, int threads = 0)
+        : games(count), restart(count, 0), pool(threads > 0 ? threads : defaultThreads()) {
+        // A few shards per thread so uneven games still balance
+        shardCount = std::min(count, pool.threads() * 4);
+        if (shardCount < 1) shardCount = 1;
+    }
+
+    int size() const {
+        return static_cast<int>(games.size());
+    }
+
+    // Starts game i from seeds[i] and writes its first observation (size() * OBS_SIZE bytes)
+    void reset(const uint32_t* seeds, uint8_t* observations) {
+        forEachGame([&](int i) {
+            games[i].reset(seeds[i]);
+            restart[i] = 0;
+            writeObservation(games[i], observations + static_cast<size_t>(i) * OBS_SIZE);
+        });
+    }
+
+    // Applies actions[i] (an Input value) to game i for one frame.
+    // rewards[i] is the points updateScoreAndLevel() awarded this step and dones[i] is set
+    // when the game ended. A finished game restarts on its next step, seeded from its own
+    // random generator, so a run stays reproducible from the reset() seeds.
+    void step(const uint8_t* actions, uint8_t* observations, float* rewards, uint8_t* dones) {
+        forEachGame([&](int i) {
+            TetrisEngine& game = games[i];
+            if (restart[i]) {
+                game.reset(game.random.next());
+                restart[i] = 0;
+            }
+
+            int before = game.score;
+            Input input = actions[i] < INPUT_COUNT ? static_cast<Input>(actions[i]) : Input::NONE;
+            game.tick(input);
+
+            bool done = game.gameState != GameState::PLAYING;
+            restart[i] = done;
+            rewards[i] = static_cast<float>(game.score - before);
+            dones[i] = done;
+            writeObservation(game, observations + static_cast<size_t>(i) * OBS_SIZE);
+        });
+    }
+
+    const TetrisEngine& game(int i) const {
+        return games[i];
+    }
+
+private:
+    std::vector<TetrisEngine> games;
+    std::vector<uint8_t> restart;
+    ShardPool pool;
+    int shardCount;
+
+    static int defaultThreads() {
+        unsigned cores = std::thread::hardware_concurrency();
+        return cores > 0 ? static_cast<int>(cores) : 1;
+    }
+
+    template <typename Fn>
+    void forEachGame(Fn fn) {
+        int count = size();
+        int perShard = (count + shardCount - 1) / shardCount;
+        auto job = [&](int shard) {
+            int begin = shard * perShard;
+            int end = std::min(count, begin + perShard);
+            for (int i = begin; i < end; i++) {
+                fn(i);
+            }
+        };
+        pool.run(shardCount, job);
+    }
+};
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <limits.h>
+
+// Constants
+const int GRID_WIDTH = 10;
+const int GRID_HEIGHT = 20;
+const int SCREEN_WIDTH = 80;
+const int SCREEN_HEIGHT = 30;
+
+// Colors for different tetromino pieces
+const int COLOR_O = 14; // Yellow
+const int COLOR_I = 11; // Light Cyan
+const int COLOR_S = 12; // Light Red
+const int COLOR_Z = 10; // Light Green
+const int COLOR_L = 6;  // Brown/Orange
+const int COLOR_J = 13; // Light Magenta
+const int COLOR_T = 5;  // Purple
+const int COLOR_GARBAGE = 8; // Dark gray, rows sent by the opponent in versus
+
+// Tetromino shapes
+class Tetromino {
+public:
+    enum class Type {
+        O, I, S, Z, L, J, T
+    };
+
+    struct Position {
+        int x;
+        int y;
+    };
+
+    // Every tetromino has exactly four blocks, so shapes live inline instead of on the heap
+    typedef std::array<Position, 4> Shape;
+
+    // Default constructor
+    Tetromino() : type(Type::O) {
+        initShape();
+    }
+
+    Tetromino(Type type) : type(type) {
+        initShape();
+    }
+
+    void initShape() {
+        switch (type) {
+        case Type::O:
+            // O shape (2x2 square)
+            shape = {{
+                {0, 0}, {1, 0},
+                {0, 1}, {1, 1}
+            }};
+            color = COLOR_O;
+            break;
+        case Type::I:
+            // I shape (vertical)
+            shape = {{
+                {0, 0},
+                {0, 1},
+                {0, 2},
+                {0, 3}
+            }};
+            color = COLOR_I;
+            break;
+        case Type::S:
+            // S shape
+            shape = {{
+                {1, 0}, {2, 0},
+                {0, 1}, {1, 1}
+            }};
+            color = COLOR_S;
+            break;
+        case Type::Z:
+            // Z shape
+            shape = {{
+                {0, 0}, {1, 0},
+                {1, 1}, {2, 1}
+            }};
+            color = COLOR_Z;
+            break;
+        case Type::L:
+            // L shape
+            shape = {{
+                {0, 0},
+                {0, 1},
+                {0, 2}, {1, 2}
+            }};
+            color = COLOR_L;
+            break;
+        case Type::J:
+            // J shape
+            shape = {{
+                        {1, 0},
+                        {1, 1},
+                {0, 2}, {1, 2}
+            }};
+            color = COLOR_J;
+            break;
+        case Type::T:
+            // T shape
+            shape = {{
+                {0, 0}, {1, 0}, {2, 0},
+                        {1, 1}
+            }};
+            color = COLOR_T;
+            break;
+        }
+    }
+
+    void rotate() {
+        // Skip rotation for O piece (square) since it looks the same
+        if (type == Type::O) return;
+
+        Shape rotated;
+        int count = 0;
+        
+        // Find center of rotation
+        int minX = INT_MAX, maxX = INT_MIN;
+        int minY = INT_MAX, maxY = INT_MIN;
+        
+        for (const auto& block : shape) {
+            minX = std::min(minX, block.x);
+            maxX = std::max(maxX, block.x);
+            minY = std::min(minY, block.y);
+            maxY = std::max(maxY, block.y);
+        }
+        
+        int centerX = (minX + maxX) / 2;
+        int centerY = (minY + maxY) / 2;
+        
+         // Special case for I piece (long bar) - it has an offset rotation center
+    if (type == Type::I) {
+        // For I piece, use a fixed rotation point 
+        // This gives better results than calculating center
+        for (const auto& block : shape) {
+            int x = block.x - 1;  // Use 1 as the center X
+            int y = block.y - 1;  // Use 1 as the center Y
+            
+            // (x, y) -> (y, -x) is a 90-degree clockwise rotation
+            rotated[count++] = {1 + y, 1 - x};
+        }
+    } else {
+        // Rotate 90 degrees clockwise around the center
+        for (const auto& block : shape) {
+            int x = block.x - centerX;
+            int y = block.y - centerY;
+            
+            // (x, y) -> (y, -x) is a 90-degree clockwise rotation
+            rotated[count++] = {centerX + y, centerY - x};
+        }
+    }
+    
+    // Update shape with rotated coordinates
+    shape = rotated;
+}
+
+    Shape getGlobalPositions(int offsetX, int offsetY) const {
+        Shape global;
+        for (int i = 0; i < 4; i++) {
+            global[i] = {shape[i].x + offsetX, shape[i].y + offsetY};
+        }
+        return global;
+    }
+
+    Type type;
+    Shape shape;
+    int color;
+};
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include "tetris_engine.h"
+
+// Garbage rows sent to the opponent for clearing 0..4 lines at once
+const int GARBAGE_FOR_LINES[5] = {0, 0, 1, 2, 4};
+
+// Two players on the same piece sequence. Multi-line clears push garbage rows
+// into the opponent's grid at the end of the frame. The whole state is plain data,
+// so saving it for rollback is a copy.
+struct VersusGame {
+    TetrisEngine players[2];
+    PieceRandom garbageRandom;
+    uint32_t frame;
+    uint32_t matches; // Finished matches
+
+    void reset(uint32_t seed) {
+        startMatch(seed);
+        frame = 0;
+        matches = 0;
+    }
+
+    void tick(Input first, Input second) {
+        // A finished match restarts on the next frame, seeded from the garbage generator,
+        // so a session stays reproducible from its first seed
+        if (over()) {
+            startMatch(garbageRandom.next());
+            matches++;
+        }
+
+        players[0].tick(first);
+        players[1].tick(second);
+
+        // Both sides finish their frame before garbage lands, so neither player goes first.
+        // A hard drop and the gravity step after it can each lock a piece, hence the clamp.
+        int sent[2] = {GARBAGE_FOR_LINES[std::min(players[0].linesJustCleared, 4)],
+                       GARBAGE_FOR_LINES[std::min(players[1].linesJustCleared, 4)]};
+        for (int p = 0; p < 2; p++) {
+            if (sent[p] > 0 && players[1 - p].gameState == GameState::PLAYING) {
+                players[1 - p].addGarbage(sent[p], static_cast<int>(garbageRandom.next() % GRID_WIDTH));
+            }
+        }
+        frame++;
+    }
+
+    bool over() const {
+        return players[0].gameState != GameState::PLAYING || players[1].gameState != GameState::PLAYING;
+    }
+
+    void startMatch(uint32_t seed) {
+        players[0].reset(seed);
+        players[1].reset(seed);
+        garbageRandom.seed(seed * 2654435761u + 1);
+    }
+};
+
+inline uint64_t hashState(const VersusGame& game) {
+    uint64_t a = hashState(game.players[0]);
+    uint64_t b = hashState(game.players[1]);
+    StateHasher h;
+    h.add(static_cast<uint32_t>(a));
+    h.add(static_cast<uint32_t>(a >> 32));
+    h.add(static_cast<uint32_t>(b));
+    h.add(static_cast<uint32_t>(b >> 32));
+    h.add(game.garbageRandom.state);
+    h.add(game.frame);
+    h.add(game.matches);
+    return h.hash;
+}
+
+// How far a peer may run ahead of the last input it has from the other peer
+const int ROLLBACK_WINDOW = 16;
+
+struct RollbackStats {
+    uint64_t frames = 0;
+    uint64_t stalls = 0;             // Frames skipped because the remote peer was too far behind
+    uint64_t rollbacks = 0;
+    uint64_t resimulatedFrames = 0;
+    uint64_t budgetOverruns = 0;     // Rollbacks whose resimulation took longer than a frame
+    int maxDepth = 0;
+    double resimulationSeconds = 0;
+    double maxResimulationSeconds = 0;
+};
+
+// One peer of a rollback versus session.
+//
+// Every frame runs immediately with the local input and a prediction of the remote
+// input (the last one received). The state before each frame is saved. When a remote
+// input arrives that differs from what was predicted, the next advance() restores the
+// state before that frame and re-simulates up to the present with the corrected inputs.
+class RollbackSession {
+public:
+    RollbackSession(int localPlayer, uint32_t seed)
+        : localPlayer(localPlayer), frame(0), remoteConfirmed(0), lastRemote(Input::NONE), rollbackFrom(-1) {
+        game.reset(seed);
+        for (int i = 0; i < REMOTE_SLOTS; i++) {
+            remoteFrame[i] = UINT32_MAX;
+        }
+    }
+
+    // Runs the next frame with this peer's input. Returns false without doing anything
+    // when the remote peer is a full window behind; call again next frame.
+    bool advance(Input localInput) {
+        if (frame - remoteConfirmed >= static_cast<uint32_t>(ROLLBACK_WINDOW)) {
+            stats.stalls++;
+            return false;
+        }
+        synchronize();
+
+        FrameRecord& record = history[frame % ROLLBACK_WINDOW];
+        record.before = game;
+        record.local = localInput;
+        record.remote = remoteInput(frame);
+        simulate(record);
+        frame++;
+        stats.frames++;
+        return true;
+    }
+
+    // An input from the other peer for one of its frames; duplicates and any order are fine
+    void receiveRemoteInput(uint32_t remoteFrameNumber, Input input) {
+        if (remoteFrameNumber < remoteConfirmed) return;
+
+        int slot = remoteFrameNumber % REMOTE_SLOTS;
+        remoteFrame[slot] = remoteFrameNumber;
+        remoteInputs[slot] = input;
+
+        // Already simulated with a guess; if the guess was wrong, rewind to here later
+        if (remoteFrameNumber < frame && history[remoteFrameNumber % ROLLBACK_WINDOW].remote != input) {
+            if (rollbackFrom < 0 || remoteFrameNumber < static_cast<uint32_t>(rollbackFrom)) {
+                rollbackFrom = remoteFrameNumber;
+            }
+        }
+
+        while (remoteFrame[remoteConfirmed % REMOTE_SLOTS] == remoteConfirmed) {
+            lastRemote = remoteInputs[remoteConfirmed % REMOTE_SLOTS];
+            remoteConfirmed++;
+        }
+    }
+
+    // Applies any pending rollback now instead of at the next advance()
+    void synchronize() {
+        if (rollbackFrom < 0) return;
+
+        auto start = std::chrono::steady_clock::now();
+        uint32_t from = static_cast<uint32_t>(rollbackFrom);
+        game = history[from % ROLLBACK_WINDOW].before;
+        for (uint32_t f = from; f < frame; f++) {
+            FrameRecord& record = history[f % ROLLBACK_WINDOW];
+            record.before = game;
+            record.remote = remoteInput(f);
+            simulate(record);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        int depth = static_cast<int>(frame - from);
+        stats.rollbacks++;
+        stats.resimulatedFrames += depth;
+        stats.maxDepth = depth > stats.maxDepth ? depth : stats.maxDepth;
+        stats.resimulationSeconds += seconds;
+        if (seconds > stats.maxResimulationSeconds) stats.maxResimulationSeconds = seconds;
+        if (seconds * 1000 > FRAME_MS) stats.budgetOverruns++;
+        rollbackFrom = -1;
+    }
+
+    const VersusGame& state() const {
+        return game;
+    }
+
+    // Frames simulated so far
+    uint32_t currentFrame() const {
+        return frame;
+    }
+
+    // Every frame before this one has its real remote input
+    uint32_t confirmedFrame() const {
+        return remoteConfirmed < frame ? remoteConfirmed : frame;
+    }
+
+    const RollbackStats& statistics() const {
+        return stats;
+    }
+
+private:
+    struct FrameRecord {
+        VersusGame before;
+        Input local;
+        Input remote;
+    };
+
+    // Remote inputs can arrive up to a window ahead of our own frame
+    static const int REMOTE_SLOTS = 2 * ROLLBACK_WINDOW;
+
+    int localPlayer;
+    VersusGame game;
+    FrameRecord history[ROLLBACK_WINDOW];
+    uint32_t remoteFrame[REMOTE_SLOTS];
+    Input remoteInputs[REMOTE_SLOTS];
+    uint32_t frame;
+    uint32_t remoteConfirmed;
+    Input lastRemote;
+    int64_t rollbackFrom;
+    RollbackStats stats;
+
+    // Real input when we have it, otherwise predict the remote peer repeats its last one
+    Input remoteInput(uint32_t f) const {
+        int slot = f % REMOTE_SLOTS;
+        return remoteFrame[slot] == f ? remoteInputs[slot] : lastRemote;
+    }
+
+    void simulate(const FrameRecord& record) {
+        if (localPlayer == 0) {
+            game.tick(record.local, record.remote);
+        } else {
+            game.tick(record.remote, record.local);
+        }
+    }
+};